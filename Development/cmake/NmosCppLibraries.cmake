@@ -1013,6 +1013,7 @@ set(NMOS_CPP_CPPREST_HEADERS
     cpprest/json_storage.h
     cpprest/json_utils.h
     cpprest/json_validator.h
+    cpprest/json_validator_impl.h
     cpprest/json_visit.h
     cpprest/logging_utils.h
     cpprest/regex_utils.h
@@ -1037,6 +1038,7 @@ set(NMOS_CPP_JWK_HEADERS
     )
 
 set(NMOS_CPP_NMOS_SOURCES
+    nmos/activation_schedule.cpp
     nmos/activation_utils.cpp
     nmos/admin_ui.cpp
     nmos/api_downgrade.cpp
@@ -1093,6 +1095,7 @@ set(NMOS_CPP_NMOS_SOURCES
     nmos/manifest_api.cpp
     nmos/mdns.cpp
     nmos/mdns_api.cpp
+    nmos/mdns_cache.cpp
     nmos/media_type.cpp
     nmos/node_api.cpp
     nmos/node_api_target_handler.cpp
@@ -1129,6 +1132,7 @@ set(NMOS_CPP_NMOS_SOURCES
     )
 set(NMOS_CPP_NMOS_HEADERS
     nmos/activation_mode.h
+    nmos/activation_schedule.h
     nmos/activation_utils.h
     nmos/admin_ui.h
     nmos/api_downgrade.h
@@ -1213,6 +1217,7 @@ set(NMOS_CPP_NMOS_HEADERS
     nmos/manifest_api.h
     nmos/mdns.h
     nmos/mdns_api.h
+    nmos/mdns_cache.h
     nmos/mdns_versions.h
     nmos/media_type.h
     nmos/mxl.h
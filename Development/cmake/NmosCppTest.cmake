@@ -40,6 +40,7 @@ set(NMOS_CPP_TEST_MDNS_TEST_HEADERS
     )
 
 set(NMOS_CPP_TEST_NMOS_TEST_SOURCES
+    nmos/test/activation_schedule_test.cpp
     nmos/test/api_utils_test.cpp
     nmos/test/bcp_008_test.cpp
     nmos/test/capabilities_test.cpp
@@ -54,15 +55,20 @@ set(NMOS_CPP_TEST_NMOS_TEST_SOURCES
     nmos/test/control_protocol_utils_test.cpp
     nmos/test/did_sdid_test.cpp
     nmos/test/event_type_test.cpp
+    nmos/test/id_test.cpp
     nmos/test/json_validator_test.cpp
     nmos/test/jwt_generator_test.cpp
     nmos/test/jwt_validation_test.cpp
     nmos/test/log_gate_test.cpp
+    nmos/test/mdns_cache_test.cpp
     nmos/test/mdns_test.cpp
+    nmos/test/model_test.cpp
     nmos/test/node_interfaces_test.cpp
     nmos/test/paging_utils_test.cpp
     nmos/test/query_api_test.cpp
+    nmos/test/query_utils_test.cpp
     nmos/test/resources_test.cpp
+    nmos/test/resources_test_utils.cpp
     nmos/test/sdp_test_utils.cpp
     nmos/test/sdp_temporal_redundancy_test.cpp
     nmos/test/sdp_utils_test.cpp
@@ -72,6 +78,7 @@ set(NMOS_CPP_TEST_NMOS_TEST_SOURCES
     nmos/test/video_jxsv_test.cpp
     )
 set(NMOS_CPP_TEST_NMOS_TEST_HEADERS
+    nmos/test/resources_test_utils.h
     nmos/test/sdp_test_utils.h
     )
 
@@ -143,6 +150,7 @@ target_link_libraries(
     nmos-cpp::cpprestsdk
     nmos-cpp::Boost
     nmos-cpp::jwt-cpp
+    nmos-cpp::json_schema_validator
     )
 if(NMOS_CPP_BUILD_LLDP)
     target_link_libraries(
@@ -16,13 +16,16 @@ namespace web
                     {
                     public:
                         typedef std::pair<utility::regex_t, utility::named_sub_matches_t> regex_named_sub_matches_type;
-                        struct route { match_flag_type flags; regex_named_sub_matches_type route_pattern; web::http::method method; route_handler handler; };
+                        // the literal prefix of the route pattern is used to reject most routes without evaluating the regex
+                        // and when the entire route pattern is literal, the regex need not be evaluated at all
+                        struct route { match_flag_type flags; regex_named_sub_matches_type route_pattern; std::pair<utility::string_t, bool> literal_prefix; web::http::method method; route_handler handler; };
                         typedef std::list<route> route_handlers;
                         typedef route_handlers::iterator iterator;
 
                         static pplx::task<bool> call(const route_handler& handler, const route_handler& exception_handler, web::http::http_request req, web::http::http_response res, const utility::string_t& route_path, const route_parameters& parameters);
                         static void handle_method_not_allowed(const route& route, web::http::http_response& res, const utility::string_t& route_path, const route_parameters& parameters);
                         static route_parameters insert(route_parameters&& into, const route_parameters& range);
+                        static bool match(const route& route, const utility::string_t& path, utility::string_t& route_match, route_parameters& route_match_parameters);
 
                         pplx::task<bool> operator()(web::http::http_request req, web::http::http_response res, const utility::string_t& route_path, const route_parameters& parameters, iterator route);
 
@@ -97,13 +100,14 @@ namespace web
                     const utility::string_t path = get_route_relative_path(req, route_path); // required, as must live longer than the match results
                     for (; routes.end() != route; ++route)
                     {
-                        utility::smatch_t route_match;
-                        if (route_regex_match(path, route_match, route->route_pattern.first, route->flags))
+                        utility::string_t route_match;
+                        route_parameters route_match_parameters;
+                        if (match(*route, path, route_match, route_match_parameters))
                         {
                             // route_path for this route handler is constructed by appending the entire matching expression
-                            const auto merged_path = route_path + route_match.str();
+                            const auto merged_path = route_path + route_match;
                             // existing parameters are inserted into the new parameters rather than vice-versa so that new parameters replace existing ones with the same name
-                            const auto merged_parameters = insert(get_parameters(route->route_pattern.second, route_match), parameters);
+                            const auto merged_parameters = insert(std::move(route_match_parameters), parameters);
 
                             if (route->method == req.method() || any_method == route->method)
                             {
@@ -211,7 +215,37 @@ namespace web
                 details::api_router_impl::iterator details::api_router_impl::insert(iterator where, match_flag_type flags, const utility::string_t& route_pattern, const web::http::method& method, route_handler handler)
                 {
                     auto parsed = utility::parse_regex_named_sub_matches(route_pattern);
-                    return routes.insert(where, { flags, { utility::regex_t(parsed.first), parsed.second }, method, handler });
+                    auto literal_prefix = utility::parse_regex_literal_prefix(parsed.first);
+                    return routes.insert(where, { flags, { utility::regex_t(parsed.first), parsed.second }, literal_prefix, method, handler });
+                }
+
+                bool details::api_router_impl::match(const route& route, const utility::string_t& path, utility::string_t& route_match, route_parameters& route_match_parameters)
+                {
+                    const auto& literal_prefix = route.literal_prefix.first;
+                    if (path.size() < literal_prefix.size() || 0 != path.compare(0, literal_prefix.size(), literal_prefix))
+                    {
+                        return false;
+                    }
+
+                    if (route.literal_prefix.second)
+                    {
+                        if (match_entire == route.flags && path.size() != literal_prefix.size())
+                        {
+                            return false;
+                        }
+                        route_match = literal_prefix;
+                        route_match_parameters.clear();
+                        return true;
+                    }
+
+                    utility::smatch_t regex_match;
+                    if (!route_regex_match(path, regex_match, route.route_pattern.first, route.flags))
+                    {
+                        return false;
+                    }
+                    route_match = regex_match.str();
+                    route_match_parameters = get_parameters(route.route_pattern.second, regex_match);
+                    return true;
                 }
 
                 route_parameters details::get_parameters(const utility::named_sub_matches_t& parameter_sub_matches, const utility::smatch_t& route_match)
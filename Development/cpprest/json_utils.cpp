@@ -377,5 +377,88 @@ namespace web
                 throw web::json::json_exception(_XPLATSTR("patch error - inconsistent type"));
             }
         }
+
+        namespace details
+        {
+            // escape a JSON Pointer reference token
+            // see https://tools.ietf.org/html/rfc6901#section-3
+            static utility::string_t escape_reference_token(const utility::string_t& token)
+            {
+                utility::string_t result;
+                result.reserve(token.size());
+                for (const auto c : token)
+                {
+                    if (_XPLATSTR('~') == c) result.append(_XPLATSTR("~0"));
+                    else if (_XPLATSTR('/') == c) result.append(_XPLATSTR("~1"));
+                    else result.push_back(c);
+                }
+                return result;
+            }
+
+            static web::json::value make_patch_operation(const utility::string_t& op, const utility::string_t& path)
+            {
+                // seems worthwhile to keep_order for readability
+                auto result = value::object(true);
+                result[_XPLATSTR("op")] = value::string(op);
+                result[_XPLATSTR("path")] = value::string(path);
+                return result;
+            }
+
+            static web::json::value make_patch_operation(const utility::string_t& op, const utility::string_t& path, const web::json::value& value)
+            {
+                auto result = make_patch_operation(op, path);
+                result[_XPLATSTR("value")] = value;
+                return result;
+            }
+
+            static void insert_patch_operations(web::json::value& operations, const utility::string_t& path, const web::json::value& source, const web::json::value& target)
+            {
+                if (source == target) return;
+
+                if (source.is_object() && target.is_object())
+                {
+                    for (const auto& field : source.as_object())
+                    {
+                        if (!target.has_field(field.first))
+                        {
+                            push_back(operations, make_patch_operation(_XPLATSTR("remove"), path + _XPLATSTR('/') + escape_reference_token(field.first)));
+                        }
+                    }
+                    for (const auto& field : target.as_object())
+                    {
+                        const auto field_path = path + _XPLATSTR('/') + escape_reference_token(field.first);
+                        if (!source.has_field(field.first))
+                        {
+                            push_back(operations, make_patch_operation(_XPLATSTR("add"), field_path, field.second));
+                        }
+                        else
+                        {
+                            insert_patch_operations(operations, field_path, source.at(field.first), field.second);
+                        }
+                    }
+                }
+                else if (source.is_array() && target.is_array() && source.size() == target.size())
+                {
+                    for (size_t index = 0; index < source.size(); ++index)
+                    {
+                        insert_patch_operations(operations, path + _XPLATSTR('/') + utility::conversions::to_string_t(std::to_string(index)), source.at(index), target.at(index));
+                    }
+                }
+                else
+                {
+                    push_back(operations, make_patch_operation(_XPLATSTR("replace"), path, target));
+                }
+            }
+        }
+
+        // make a JSON Patch, i.e. an array of operations which transform the source value into the target value
+        // only "add", "remove" and "replace" operations are used, and arrays which have changed size are replaced in their entirety
+        // see https://tools.ietf.org/html/rfc6902
+        web::json::value diff(const web::json::value& source, const web::json::value& target)
+        {
+            auto result = value::array();
+            details::insert_patch_operations(result, {}, source, target);
+            return result;
+        }
     }
 }
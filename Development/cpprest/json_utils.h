@@ -288,6 +288,11 @@ namespace web
 
         // merge source into target value
         void merge_patch(web::json::value& value, const web::json::value& patch, bool permissive = false);
+
+        // make a JSON Patch, i.e. an array of operations which transform the source value into the target value
+        // only "add", "remove" and "replace" operations are used, and arrays which have changed size are replaced in their entirety
+        // see https://tools.ietf.org/html/rfc6902
+        web::json::value diff(const web::json::value& source, const web::json::value& target);
     }
 }
 
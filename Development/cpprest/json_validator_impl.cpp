@@ -3,6 +3,7 @@
 #include "bst/regex.h"
 #include "cpprest/basic_utils.h"
 #include "cpprest/json.h"
+#include "cpprest/json_validator_impl.h"
 // use of nlohmann/json and pboettch/json-schema-validator should be an implementation detail, i.e. not in a public header file
 #include "detail/pragma_warnings.h"
 PRAGMA_WARNING_PUSH
@@ -89,7 +90,7 @@ namespace web
                                 {
                                     const auto id = web::uri(utility::s2us(id_impl.url()));
                                     const auto value = load_schema(id);
-                                    value_impl = nlohmann::json::parse(utility::us2s(value.serialize()));
+                                    value_impl = to_basic_json<nlohmann::json>(value);
                                 },
                                 check_format
                             };
@@ -121,7 +122,7 @@ namespace web
 
                         try
                         {
-                            auto instance = nlohmann::json::parse(utility::us2s(value.serialize()));
+                            const auto instance = to_basic_json<nlohmann::json>(value);
                             validator->second.validate(instance, error_handler);
                         }
                         catch (const web::json::json_exception&)
@@ -0,0 +1,63 @@
+#ifndef CPPREST_JSON_VALIDATOR_IMPL_H
+#define CPPREST_JSON_VALIDATOR_IMPL_H
+
+#include "cpprest/basic_utils.h" // for utility::us2s
+#include "cpprest/json.h"
+
+namespace web
+{
+    namespace json
+    {
+        namespace experimental
+        {
+            namespace details
+            {
+                // convert the specified value to the instance type of the underlying json validator implementation,
+                // i.e. nlohmann::json, by walking the tree directly rather than serializing the value and parsing the result
+                // (this is a template so that the underlying implementation doesn't need to be exposed by this header file)
+                template <typename BasicJson>
+                BasicJson to_basic_json(const web::json::value& value)
+                {
+                    switch (value.type())
+                    {
+                    case web::json::value::Boolean:
+                        return BasicJson(value.as_bool());
+                    case web::json::value::Number:
+                    {
+                        const auto& number = value.as_number();
+                        if (!number.is_integral()) return BasicJson(value.as_double());
+                        // like parsing, only use the signed integer type for negative numbers
+                        if (number.is_int64() && number.to_int64() < 0) return BasicJson(number.to_int64());
+                        return BasicJson(number.to_uint64());
+                    }
+                    case web::json::value::String:
+                        return BasicJson(utility::us2s(value.as_string()));
+                    case web::json::value::Object:
+                    {
+                        auto result = BasicJson::object();
+                        for (const auto& field : value.as_object())
+                        {
+                            result.emplace(utility::us2s(field.first), to_basic_json<BasicJson>(field.second));
+                        }
+                        return result;
+                    }
+                    case web::json::value::Array:
+                    {
+                        auto result = BasicJson::array();
+                        for (const auto& element : value.as_array())
+                        {
+                            result.push_back(to_basic_json<BasicJson>(element));
+                        }
+                        return result;
+                    }
+                    case web::json::value::Null:
+                    default:
+                        return BasicJson();
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef CPPREST_REGEX_UTILS_H
 #define CPPREST_REGEX_UTILS_H
 
+#include <locale>
 #include <map>
 #include "bst/regex.h"
 
@@ -167,6 +168,66 @@ namespace xregex
         }
         return result;
     }
+
+    // parse_regex_literal_prefix determines the literal prefix of a regular expression that is appropriate for bst::regex_match, etc.
+    // i.e. the characters that any match must start with, and whether the entire regular expression is literal
+    // the result is conservative, e.g. any top-level alternation means there is no literal prefix
+    template <typename Char>
+    std::pair<string_t<Char>, bool> parse_regex_literal_prefix(const string_t<Char>& regex)
+    {
+        using namespace regex_specials;
+        static const string_t<Char> specials{ '^', '$', '.', '|', '?', '*', '+', '(', ')', '[', ']', '{', '}' };
+        static const string_t<Char> quantifiers{ '?', '*', '{' };
+
+        std::pair<string_t<Char>, bool> result{ {}, false };
+
+        // check for top-level alternation
+        {
+            int depth = 0;
+            bool bracket = false;
+            for (auto it = regex.begin(); regex.end() != it; ++it)
+            {
+                if (escape == *it)
+                {
+                    if (regex.end() == ++it) break;
+                }
+                else if (bracket)
+                {
+                    if (']' == *it) bracket = false;
+                }
+                else if ('[' == *it) bracket = true;
+                else if (sub_match_start == *it) ++depth;
+                else if (sub_match_finish == *it) --depth;
+                else if ('|' == *it && 0 == depth) return result;
+            }
+        }
+
+        auto it = regex.begin();
+        while (regex.end() != it)
+        {
+            Char ch = *it;
+            auto next = std::next(it);
+            if (escape == ch)
+            {
+                // only an escaped punctuation character is a literal, e.g. "\." but not "\d"
+                if (regex.end() == next || std::isalnum(*next, std::locale::classic())) return result;
+                ch = *next++;
+            }
+            else if (string_t<Char>::npos != specials.find(ch))
+            {
+                return result;
+            }
+
+            // a quantified character is not part of the literal prefix, e.g. "/?"
+            if (regex.end() != next && string_t<Char>::npos != quantifiers.find(*next)) return result;
+
+            result.first.push_back(ch);
+            it = next;
+        }
+
+        result.second = true;
+        return result;
+    }
 }
 
 #include "cpprest/details/basic_types.h"
@@ -190,6 +251,11 @@ namespace utility
     {
         return ::xregex::parse_regex_named_sub_matches(regex);
     }
+
+    inline std::pair<string_t, bool> parse_regex_literal_prefix(const string_t& regex)
+    {
+        return ::xregex::parse_regex_literal_prefix(regex);
+    }
 }
 
 #endif
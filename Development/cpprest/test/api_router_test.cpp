@@ -1,6 +1,7 @@
 // The first "test" is of course whether the header compiles standalone
 #include "cpprest/api_router.h"
 
+#include <vector>
 #include "bst/test/test.h"
 #include "cpprest/basic_utils.h" // for utility::us2s, utility::s2us
 
@@ -91,3 +92,125 @@ BST_TEST_CASE(testGetParameters)
     BST_REQUIRE(bst::regex_match(path, route_match, route_regex));
     BST_REQUIRE(expected == get_parameters(parameter_sub_matches, route_match));
 }
+
+namespace
+{
+    // dispatch a GET request for the specified path, returning whether to continue matching routes
+    bool dispatch(web::http::experimental::listener::api_router& router, const utility::string_t& path)
+    {
+        web::http::http_request req(web::http::methods::GET);
+        req.set_request_uri(web::uri(U("http://host:123") + path));
+        web::http::http_response res;
+        return router(req, res, {}, {}).get();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testApiRouterDispatch)
+{
+    using namespace web::http::experimental::listener::api_router_using_declarations;
+
+    std::vector<utility::string_t> matched;
+    const auto record = [&matched](http_request, http_response, const string_t& route_path, const route_parameters& parameters)
+    {
+        const auto id = parameters.find(U("id"));
+        matched.push_back(route_path + (parameters.end() != id ? U(";") + id->second : U("")));
+        return pplx::task_from_result(true);
+    };
+
+    api_router router;
+    router.support(U("/foo/?"), methods::GET, record);
+    router.support(U("/foo/") + utility::make_named_sub_match(U("id"), U("[a-z]+")), methods::GET, record);
+    router.mount(U("/foo"), methods::GET, record);
+    router.support(U("/bar"), methods::GET, record);
+
+    BST_REQUIRE(dispatch(router, U("/foo/")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/foo/"), U("/foo") } == matched));
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/foo/baz")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/foo/baz;baz"), U("/foo") } == matched));
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/foo")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/foo"), U("/foo") } == matched));
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/bar")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/bar") } == matched));
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/bar/")));
+    BST_REQUIRE(matched.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Routes are rejected by their literal prefix before any regex is evaluated, which mustn't change which routes match
+BST_TEST_CASE(testApiRouterDispatchLiteralPrefix)
+{
+    using namespace web::http::experimental::listener::api_router_using_declarations;
+
+    std::vector<utility::string_t> matched;
+    const auto record = [&matched](http_request, http_response, const string_t& route_path, const route_parameters& parameters)
+    {
+        const auto id = parameters.find(U("id"));
+        matched.push_back(route_path + (parameters.end() != id ? U(";") + id->second : U("")));
+        return pplx::task_from_result(true);
+    };
+
+    const size_t route_count = 32;
+    const auto id_pattern = U("[0-9a-f]{8}-[0-9a-f]{4}-[1-5][0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}");
+    const utility::string_t id{ U("e2f8a5c3-5a61-4a1e-9a4b-6c1b6c2e3f4d") };
+
+    api_router router;
+    for (size_t i = 0; i < route_count; ++i)
+    {
+        router.support(U("/route") + utility::s2us(std::to_string(i)) + U("/") + utility::make_named_sub_match(U("id"), id_pattern) + U("/?"), methods::GET, record);
+    }
+    // escaped and quantified characters
+    router.support(U("/a\\.b"), methods::GET, record);
+    router.support(U("/c/?"), methods::GET, record);
+    // top-level alternation
+    router.support(U("/d|/e"), methods::GET, record);
+
+    // each path matches only its own route, e.g. "/route1/..." doesn't match "/route10/..." or vice versa
+    for (size_t i = 0; i < route_count; ++i)
+    {
+        const auto path = U("/route") + utility::s2us(std::to_string(i)) + U("/") + id + U("/");
+
+        matched.clear();
+        BST_REQUIRE(dispatch(router, path));
+        BST_REQUIRE((std::vector<utility::string_t>{ path + U(";") + id } == matched));
+    }
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/route3/") + id));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/route3/") + id + U(";") + id } == matched));
+
+    // a literal prefix match doesn't mean the route matches
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/route3/not-an-id/")));
+    BST_REQUIRE(matched.empty());
+
+    BST_REQUIRE(dispatch(router, U("/route") + utility::s2us(std::to_string(route_count)) + U("/") + id + U("/")));
+    BST_REQUIRE(matched.empty());
+
+    BST_REQUIRE(dispatch(router, U("/route")));
+    BST_REQUIRE(matched.empty());
+
+    BST_REQUIRE(dispatch(router, U("/a.b")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/a.b") } == matched));
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/axb")));
+    BST_REQUIRE(matched.empty());
+
+    BST_REQUIRE(dispatch(router, U("/c")));
+    BST_REQUIRE(dispatch(router, U("/c/")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/c"), U("/c/") } == matched));
+
+    matched.clear();
+    BST_REQUIRE(dispatch(router, U("/d")));
+    BST_REQUIRE(dispatch(router, U("/e")));
+    BST_REQUIRE((std::vector<utility::string_t>{ U("/d"), U("/e") } == matched));
+}
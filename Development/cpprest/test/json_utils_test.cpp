@@ -238,6 +238,34 @@ BST_TEST_CASE(testMergePatchRFC7386)
     BST_REQUIRE_EQUAL(expected, merged_permissive(target, source));
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testDiff)
+{
+    using web::json::value;
+
+    const auto source = value::parse(U(R"-json-({"a": 1, "b": {"c": "x", "d": [1, 2]}, "e/f": true, "g": [1]})-json-"));
+    const auto target = value::parse(U(R"-json-({"a": 1, "b": {"c": "y", "d": [1, 3]}, "g": [1, 2], "h": null})-json-"));
+
+    // removed members, then added or changed members, with elements of arrays of the same size compared individually
+    const auto expected = value::parse(U(R"-json-([
+        {"op": "remove", "path": "/e~1f"},
+        {"op": "replace", "path": "/b/c", "value": "y"},
+        {"op": "replace", "path": "/b/d/1", "value": 3},
+        {"op": "replace", "path": "/g", "value": [1, 2]},
+        {"op": "add", "path": "/h", "value": null}
+    ])-json-"));
+
+    BST_REQUIRE_EQUAL(expected, web::json::diff(source, target));
+
+    // no operations are required for equal values
+    BST_REQUIRE_EQUAL(value::array(), web::json::diff(source, source));
+
+    // values of different types are replaced in their entirety
+    const auto replace = web::json::diff(source, value::array());
+    BST_REQUIRE_EQUAL(1u, replace.size());
+    BST_REQUIRE_EQUAL(U(""), replace.at(0).at(U("path")).as_string());
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 BST_TEST_CASE(testPreprocess)
 {
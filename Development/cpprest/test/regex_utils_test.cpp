@@ -50,3 +50,39 @@ BST_TEST_CASE(testParseRegexNamedSubMatchesWithTrickiness)
     BST_REQUIRE_EQUAL(2, actual.second.at(U("foo")));
     BST_REQUIRE_EQUAL(3, actual.second.at(U("baz")));
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testParseRegexLiteralPrefix)
+{
+    const std::pair<utility::string_t, bool> literal{ U("/foo/bar"), true };
+    BST_REQUIRE(literal == utility::parse_regex_literal_prefix(U("/foo/bar")));
+
+    const std::pair<utility::string_t, bool> empty{ U(""), true };
+    BST_REQUIRE(empty == utility::parse_regex_literal_prefix(U("")));
+
+    // escaped punctuation is literal
+    const std::pair<utility::string_t, bool> escaped{ U("/foo.bar"), true };
+    BST_REQUIRE(escaped == utility::parse_regex_literal_prefix(U("/foo\\.bar")));
+
+    // a sub-match, character class, character class escape, etc. ends the literal prefix
+    const std::pair<utility::string_t, bool> sub_match{ U("/x-nmos/"), false };
+    BST_REQUIRE(sub_match == utility::parse_regex_literal_prefix(U("/x-nmos/(node)/")));
+    const std::pair<utility::string_t, bool> character_class{ U("/v"), false };
+    BST_REQUIRE(character_class == utility::parse_regex_literal_prefix(U("/v[0-9]+")));
+    const std::pair<utility::string_t, bool> character_class_escape{ U("/v"), false };
+    BST_REQUIRE(character_class_escape == utility::parse_regex_literal_prefix(U("/v\\d+")));
+
+    // a quantified character is not part of the literal prefix
+    const std::pair<utility::string_t, bool> optional{ U("/foo"), false };
+    BST_REQUIRE(optional == utility::parse_regex_literal_prefix(U("/foo/?")));
+    const std::pair<utility::string_t, bool> one_or_more{ U("/foo/"), false };
+    BST_REQUIRE(one_or_more == utility::parse_regex_literal_prefix(U("/foo/+")));
+
+    // top-level alternation means there is no literal prefix, but a nested one doesn't
+    const std::pair<utility::string_t, bool> alternation{ U(""), false };
+    BST_REQUIRE(alternation == utility::parse_regex_literal_prefix(U("/foo|/bar")));
+    const std::pair<utility::string_t, bool> nested_alternation{ U("/"), false };
+    BST_REQUIRE(nested_alternation == utility::parse_regex_literal_prefix(U("/(foo|bar)")));
+    const std::pair<utility::string_t, bool> bracketed{ U("/"), false };
+    BST_REQUIRE(bracketed == utility::parse_regex_literal_prefix(U("/[|(]")));
+}
@@ -27,3 +27,44 @@ BST_TEST_CASE(testWebSocketListenerCloseOpen)
     // hmm, ran out of dynamic ports?!
     BST_REQUIRE(false);
 }
+
+BST_TEST_CASE(testWebSocketListenerThreadPool)
+{
+    web::websockets::experimental::listener::websocket_listener_config config;
+    config.set_thread_pool_size(4);
+    config.set_send_buffer_limit(65536);
+    config.set_send_queue_limit(16);
+    config.set_send_queue_policy(web::websockets::experimental::listener::send_queue_policy::drop_oldest);
+
+    for (auto port = 49152; port <= 65535; ++port)
+    {
+        web::websockets::experimental::listener::websocket_listener ws(web::uri_builder(U("ws://localhost")).set_port(port).to_uri(), config);
+        try
+        {
+            ws.open().wait();
+        }
+        catch (const web::websockets::websocket_exception&)
+        {
+            // could well be that port is already in use, so just try the next one
+            continue;
+        }
+
+        // there are no metrics for a connection that isn't open
+        const auto metrics = ws.metrics({});
+        BST_REQUIRE_EQUAL(0u, metrics.queue_depth);
+        BST_REQUIRE_EQUAL(0u, metrics.sent);
+
+        // sending to a connection that isn't open fails immediately
+        web::websockets::websocket_outgoing_message message;
+        message.set_utf8_message("foo");
+        BST_REQUIRE_THROW(ws.send({}, message).wait(), web::websockets::websocket_exception);
+
+        // all the threads ought to be joined
+        ws.close().wait();
+        ws.open().wait();
+        ws.close().wait();
+        return;
+    }
+    // hmm, ran out of dynamic ports?!
+    BST_REQUIRE(false);
+}
@@ -3,6 +3,8 @@
 
 #if !defined(CPPREST_EXCLUDE_WEBSOCKETS)
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -89,6 +91,31 @@ namespace web
                     web::websockets::experimental::listener::message_handler message_handler;
                 };
 
+                // the policy applied when a message is sent to a connection whose send queue is full
+                enum class send_queue_policy
+                {
+                    disconnect, // close the connection, since the client isn't keeping up
+                    drop_oldest // drop the oldest queued message
+                };
+
+                // metrics for the outgoing messages of a connection
+                struct connection_metrics
+                {
+                    connection_metrics() : queue_depth(0), buffered_amount(0), sent(0), dropped(0), last_send_latency(0), max_send_latency(0) {}
+
+                    // number of messages queued, i.e. not yet handed over to the connection
+                    size_t queue_depth;
+                    // number of bytes handed over to the connection, but not yet written to the socket
+                    size_t buffered_amount;
+                    // number of messages handed over to the connection
+                    uint64_t sent;
+                    // number of messages dropped due to the send queue policy
+                    uint64_t dropped;
+                    // the time between send being called for a message and it being handed over to the connection
+                    std::chrono::microseconds last_send_latency;
+                    std::chrono::microseconds max_send_latency;
+                };
+
 #if !defined(_WIN32) || !defined(__cplusplus_winrt)
                 // ultimately, this would seem to belong in web, in order to also be adopted by web::http, but until that time...
                 typedef std::function<void(boost::asio::ssl::context&)> ssl_context_callback;
@@ -97,7 +124,7 @@ namespace web
                 class websocket_listener_config
                 {
                 public:
-                    websocket_listener_config() : m_backlog(0) {}
+                    websocket_listener_config() : m_backlog(0), m_thread_pool_size(1), m_send_buffer_limit(0), m_send_queue_limit(0), m_send_queue_policy(web::websockets::experimental::listener::send_queue_policy::disconnect) {}
 
                     const web::logging::experimental::log_handler& get_log_callback() const
                     {
@@ -119,6 +146,50 @@ namespace web
                         m_backlog = backlog;
                     }
 
+                    // the number of threads used to run the listener's I/O, e.g. writing to the connections
+                    int thread_pool_size() const
+                    {
+                        return m_thread_pool_size;
+                    }
+
+                    void set_thread_pool_size(int thread_pool_size)
+                    {
+                        m_thread_pool_size = thread_pool_size;
+                    }
+
+                    // the number of bytes that may be handed over to a connection but not yet written, above which further messages are queued,
+                    // or zero for no limit, in which case messages are never queued
+                    size_t send_buffer_limit() const
+                    {
+                        return m_send_buffer_limit;
+                    }
+
+                    void set_send_buffer_limit(size_t send_buffer_limit)
+                    {
+                        m_send_buffer_limit = send_buffer_limit;
+                    }
+
+                    // the maximum number of messages queued for a connection, above which the send queue policy is applied, or zero for no limit
+                    size_t send_queue_limit() const
+                    {
+                        return m_send_queue_limit;
+                    }
+
+                    void set_send_queue_limit(size_t send_queue_limit)
+                    {
+                        m_send_queue_limit = send_queue_limit;
+                    }
+
+                    web::websockets::experimental::listener::send_queue_policy send_queue_policy() const
+                    {
+                        return m_send_queue_policy;
+                    }
+
+                    void set_send_queue_policy(web::websockets::experimental::listener::send_queue_policy send_queue_policy)
+                    {
+                        m_send_queue_policy = send_queue_policy;
+                    }
+
 #if !defined(_WIN32) || !defined(__cplusplus_winrt)
                     const ssl_context_callback& get_ssl_context_callback() const
                     {
@@ -134,6 +205,10 @@ namespace web
                 private:
                     web::logging::experimental::log_handler m_log_callback;
                     int m_backlog;
+                    int m_thread_pool_size;
+                    size_t m_send_buffer_limit;
+                    size_t m_send_queue_limit;
+                    web::websockets::experimental::listener::send_queue_policy m_send_queue_policy;
 #if !defined(_WIN32) || !defined(__cplusplus_winrt)
                     ssl_context_callback m_ssl_context_callback;
 #endif
@@ -169,8 +244,13 @@ namespace web
                     pplx::task<void> close();
                     pplx::task<void> close(websocket_close_status close_status, const utility::string_t& close_reason = {});
 
+                    // the returned task completes when the message has been handed over to the connection, which may be after it has been queued
+                    // or it fails if the connection is invalid or is closed, or the message is dropped, according to the send queue policy
                     pplx::task<void> send(const connection_id& connection, websocket_outgoing_message message);
 
+                    // get the metrics for the outgoing messages of an open connection (they are also logged when the connection is closed)
+                    connection_metrics metrics(const connection_id& connection) const;
+
                     websocket_listener(websocket_listener&& other);
                     websocket_listener& operator=(websocket_listener&& other);
 
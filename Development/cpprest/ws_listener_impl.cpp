@@ -1,7 +1,10 @@
 #include "cpprest/ws_listener.h"
 
+#include <deque>
+#include <map>
 #include <mutex>
-#include <set>
+#include <thread>
+#include <vector>
 #include "detail/pragma_warnings.h"
 #include "detail/private_access.h"
 
@@ -228,6 +231,7 @@ namespace web
                         virtual pplx::task<void> close(const connection_id& connection, websocket_close_status close_status, const utility::string_t& close_reason) = 0;
                         virtual pplx::task<void> close(websocket_close_status close_status, const utility::string_t& close_reason) = 0;
                         virtual pplx::task<void> send(const connection_id& connection, websocket_outgoing_message message) = 0;
+                        virtual connection_metrics metrics(const connection_id& connection) = 0;
 
                     protected:
                         // extend friendship with connection_id to derived classes
@@ -325,8 +329,12 @@ namespace web
 #endif
                                 }
                                 server.start_perpetual();
-                                // hmm, is one thread enough?
-                                thread = std::thread(&server_t::run, &server);
+                                // run the io_service on the configured number of threads
+                                const int thread_pool_size = (std::max)(1, configuration().thread_pool_size());
+                                for (int i = 0; i < thread_pool_size; ++i)
+                                {
+                                    threads.push_back(std::thread(&server_t::run, &server));
+                                }
 
                                 using websocketpp::lib::bind;
                                 using websocketpp::lib::placeholders::_1;
@@ -383,10 +391,7 @@ namespace web
 
                         pplx::task<void> close(const connection_id& connection, websocket_close_status close_status, const utility::string_t& close_reason)
                         {
-                            {
-                                std::lock_guard<std::mutex> lock(mutex);
-                                connections.erase(hdl_from_id(connection));
-                            }
+                            erase_connection(hdl_from_id(connection));
 
                             try
                             {
@@ -431,10 +436,11 @@ namespace web
                                 const auto reason = utility::conversions::to_utf8string(close_reason);
 
                                 websocketpp::lib::error_code ec;
-                                for (auto& hdl : cons)
+                                for (auto& con : cons)
                                 {
+                                    fail_queued_messages(con.second, "close");
                                     websocketpp::lib::error_code con_ec;
-                                    server.close(hdl, static_cast<websocketpp::close::status::value>(close_status), reason, con_ec);
+                                    server.close(con.first, static_cast<websocketpp::close::status::value>(close_status), reason, con_ec);
                                     if (!ec && con_ec) ec = con_ec;
                                 }
                                 if (ec) throw websocketpp::exception(ec);
@@ -442,18 +448,12 @@ namespace web
                             catch (const websocketpp::exception& e)
                             {
                                 server.stop_perpetual();
-                                if (thread.joinable())
-                                {
-                                    thread.join();
-                                }
+                                join_threads();
                                 return pplx::task_from_exception<void>(websocket_exception(e.code(), build_error_msg(e.code(), "close")));
                             }
 
                             server.stop_perpetual();
-                            if (thread.joinable())
-                            {
-                                thread.join();
-                            }
+                            join_threads();
                             return pplx::task_from_result();
                         }
 
@@ -471,24 +471,279 @@ namespace web
                                 return pplx::task_from_exception<void>(websocket_exception("Invalid message body"));
                             }
 
-                            try
-                            {
-                                // send will throw if the connection_hdl isn't valid
-                                server.send(hdl_from_id(connection), ptr, count, websocketpp::frame::opcode::text);
-                            }
-                            catch (const websocketpp::exception& e)
+                            const auto hdl = hdl_from_id(connection);
+                            const auto now = std::chrono::steady_clock::now();
+
+                            std::unique_lock<std::mutex> lock(mutex);
+
+                            // if there are no messages already queued or being handed over for the connection and it isn't congested,
+                            // hand over the message immediately, followed by any messages queued meanwhile
+                            auto found = connections.find(hdl);
+                            if (connections.end() == found || (found->second.messages.empty() && !found->second.draining && !congested(hdl)))
                             {
+                                const bool open = connections.end() != found;
+                                if (open)
+                                {
+                                    found->second.draining = true;
+                                    record_sent(found->second.metrics, now);
+                                }
+                                lock.unlock();
+
+                                // send will fail if the connection_hdl isn't valid
+                                websocketpp::lib::error_code ec;
+                                server.send(hdl, ptr, count, websocketpp::frame::opcode::text, ec);
                                 body.release(ptr, count);
-                                return pplx::task_from_exception<void>(websocket_exception(e.code(), build_error_msg(e.code(), "send")));
+
+                                if (open) send_queued_messages(hdl);
+
+                                if (ec) return pplx::task_from_exception<void>(websocket_exception(ec, build_error_msg(ec, "send")));
+                                return pplx::task_from_result();
                             }
 
+                            // otherwise, queue the message, to be handed over when the connection is no longer congested
+                            auto& queue = found->second;
+                            queue.messages.push_back({ std::string((const char*)ptr, count), now, {} });
                             body.release(ptr, count);
-                            return pplx::task_from_result();
+                            auto sent = pplx::create_task(queue.messages.back().sent);
+
+                            const auto send_queue_limit = configuration().send_queue_limit();
+                            if (0 != send_queue_limit && send_queue_limit < queue.messages.size())
+                            {
+                                if (send_queue_policy::drop_oldest == configuration().send_queue_policy())
+                                {
+                                    auto dropped = std::move(queue.messages.front());
+                                    queue.messages.pop_front();
+                                    ++queue.metrics.dropped;
+                                    // only the first message dropped is logged, to avoid flooding the log; the total is logged when the connection is closed
+                                    const bool first_dropped = 1 == queue.metrics.dropped;
+                                    lock.unlock();
+
+                                    dropped.sent.set_exception(websocket_exception("send: message dropped because the send queue is full"));
+                                    if (first_dropped) server.get_elog().write(websocketpp::log::elevel::warn, "dropping messages because the send queue is full");
+                                    return sent;
+                                }
+                                else // if (send_queue_policy::disconnect == configuration().send_queue_policy())
+                                {
+                                    // the client isn't keeping up, so close the connection rather than allowing messages to accumulate
+                                    send_queue closed;
+                                    using std::swap;
+                                    swap(closed, queue);
+                                    connections.erase(found);
+                                    lock.unlock();
+
+                                    for (auto& message : closed.messages)
+                                    {
+                                        message.sent.set_exception(websocket_exception("send: connection closed because the send queue is full"));
+                                    }
+
+                                    server.get_elog().write(websocketpp::log::elevel::warn, "closing connection because the send queue is full; " + build_metrics_msg(closed));
+                                    websocketpp::lib::error_code ec;
+                                    server.close(hdl, websocketpp::close::status::try_again_later, "Send queue full", ec);
+                                    return sent;
+                                }
+                            }
+
+                            // if the queued messages are already being handed over, this message will be too
+                            if (queue.draining) return sent;
+
+                            // otherwise, if the connection is still congested, wait for it to catch up
+                            if (congested(hdl))
+                            {
+                                schedule_send_queued_messages(hdl, queue);
+                                return sent;
+                            }
+
+                            // or if it has caught up, hand over the queued messages now
+                            queue.draining = true;
+                            lock.unlock();
+                            send_queued_messages(hdl);
+                            return sent;
+                        }
+
+                        connection_metrics metrics(const connection_id& connection)
+                        {
+                            const auto hdl = hdl_from_id(connection);
+
+                            std::lock_guard<std::mutex> lock(mutex);
+
+                            auto found = connections.find(hdl);
+                            if (connections.end() == found) return{};
+
+                            auto result = found->second.metrics;
+                            result.queue_depth = found->second.messages.size();
+                            websocketpp::lib::error_code ec;
+                            auto con = server.get_con_from_hdl(hdl, ec);
+                            if (!ec) result.buffered_amount = con->get_buffered_amount();
+                            return result;
                         }
 
                     private:
                         typedef websocketpp::server<WsppConfig> server_t;
-                        typedef std::set<websocketpp::connection_hdl, std::owner_less<websocketpp::connection_hdl>> connections_t;
+
+                        // a message that has been queued for a connection, because the connection was congested
+                        struct queued_message
+                        {
+                            std::string payload;
+                            std::chrono::steady_clock::time_point queued;
+                            pplx::task_completion_event<void> sent;
+                        };
+
+                        // the outgoing messages of a connection which have not yet been handed over to websocketpp
+                        struct send_queue
+                        {
+                            send_queue() : draining(false), scheduled(false) {}
+
+                            std::deque<queued_message> messages;
+                            bool draining; // flag to identify whether a thread is handing over messages, so any further messages must be queued behind them
+                            bool scheduled; // flag to identify whether a timer is pending to send the queued messages
+                            connection_metrics metrics;
+                        };
+
+                        typedef std::map<websocketpp::connection_hdl, send_queue, std::owner_less<websocketpp::connection_hdl>> connections_t;
+
+                        // interval after which a connection that is still congested once the queued messages can no longer be handed over is checked again,
+                        // unless a further message is sent to it first, since websocketpp provides no notification when a connection's buffered data has been written
+                        static const long send_queue_interval = 10; // milliseconds
+
+                        // determine whether the connection has buffered at least the configured limit, so any further messages should be queued
+                        // the lock on connections must be held
+                        bool congested(websocketpp::connection_hdl hdl)
+                        {
+                            const auto send_buffer_limit = configuration().send_buffer_limit();
+                            if (0 == send_buffer_limit) return false;
+                            websocketpp::lib::error_code ec;
+                            auto con = server.get_con_from_hdl(hdl, ec);
+                            return !ec && send_buffer_limit <= con->get_buffered_amount();
+                        }
+
+                        static void record_sent(connection_metrics& metrics, std::chrono::steady_clock::time_point queued)
+                        {
+                            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued);
+                            ++metrics.sent;
+                            metrics.last_send_latency = latency;
+                            if (metrics.max_send_latency < latency) metrics.max_send_latency = latency;
+                        }
+
+                        static std::string build_metrics_msg(const send_queue& queue)
+                        {
+                            std::stringstream ss;
+                            ss.imbue(std::locale::classic());
+                            ss << "sent: " << queue.metrics.sent
+                                << ", dropped: " << queue.metrics.dropped
+                                << ", queued: " << queue.messages.size()
+                                << ", max send latency: " << queue.metrics.max_send_latency.count() << "us";
+                            return ss.str();
+                        }
+
+                        static void fail_queued_messages(send_queue& queue, const std::string& location)
+                        {
+                            for (auto& message : queue.messages)
+                            {
+                                message.sent.set_exception(websocket_exception(location + ": connection closed"));
+                            }
+                            queue.messages.clear();
+                        }
+
+                        // the lock on connections must be held
+                        void schedule_send_queued_messages(websocketpp::connection_hdl hdl, send_queue& queue)
+                        {
+                            if (queue.scheduled) return;
+                            queue.scheduled = true;
+
+                            using websocketpp::lib::bind;
+                            using websocketpp::lib::placeholders::_1;
+                            server.set_timer(send_queue_interval, bind(&websocket_listener_wspp::handle_send_queue_timer, this, hdl, _1));
+                        }
+
+                        void handle_send_queue_timer(websocketpp::connection_hdl hdl, const websocketpp::lib::error_code& ec)
+                        {
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+
+                                // if the connection has been closed, any queued messages have already been failed
+                                auto found = connections.find(hdl);
+                                if (connections.end() == found) return;
+
+                                auto& queue = found->second;
+                                queue.scheduled = false;
+
+                                // the timer is cancelled when the listener is closed
+                                if (ec) return;
+
+                                // if the queued messages are already being handed over, there's nothing to do
+                                if (queue.draining) return;
+                                queue.draining = true;
+                            }
+
+                            send_queued_messages(hdl);
+                        }
+
+                        // hand over the queued messages one at a time, without holding the lock while each is sent, until the connection is congested again
+                        // the calling thread must have set the draining flag, which is cleared when there are no more messages that can be handed over
+                        void send_queued_messages(websocketpp::connection_hdl hdl)
+                        {
+                            for (;;)
+                            {
+                                queued_message message;
+                                {
+                                    std::lock_guard<std::mutex> lock(mutex);
+
+                                    // if the connection has been closed, any queued messages have already been failed
+                                    auto found = connections.find(hdl);
+                                    if (connections.end() == found) return;
+
+                                    auto& queue = found->second;
+                                    if (queue.messages.empty() || congested(hdl))
+                                    {
+                                        queue.draining = false;
+                                        if (!queue.messages.empty()) schedule_send_queued_messages(hdl, queue);
+                                        return;
+                                    }
+
+                                    message = std::move(queue.messages.front());
+                                    queue.messages.pop_front();
+                                    record_sent(queue.metrics, message.queued);
+                                }
+
+                                websocketpp::lib::error_code ec;
+                                server.send(hdl, message.payload, websocketpp::frame::opcode::text, ec);
+                                if (!ec)
+                                {
+                                    message.sent.set();
+                                }
+                                else
+                                {
+                                    message.sent.set_exception(websocket_exception(ec, build_error_msg(ec, "send")));
+                                }
+                            }
+                        }
+
+                        void erase_connection(websocketpp::connection_hdl hdl)
+                        {
+                            send_queue queue;
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                auto found = connections.find(hdl);
+                                if (connections.end() == found) return;
+                                using std::swap;
+                                swap(queue, found->second);
+                                connections.erase(found);
+                            }
+                            server.get_alog().write(websocketpp::log::alevel::app, "connection send queue closed; " + build_metrics_msg(queue));
+                            fail_queued_messages(queue, "close");
+                        }
+
+                        void join_threads()
+                        {
+                            for (auto& thread : threads)
+                            {
+                                if (thread.joinable())
+                                {
+                                    thread.join();
+                                }
+                            }
+                            threads.clear();
+                        }
 
                         web::uri uri_from_hdl(websocketpp::connection_hdl hdl)
                         {
@@ -581,7 +836,7 @@ namespace web
                         {
                             {
                                 std::lock_guard<std::mutex> lock(mutex);
-                                connections.insert(hdl);
+                                connections.insert({ hdl, {} });
                             }
 
                             if (user_open)
@@ -592,10 +847,7 @@ namespace web
 
                         void handle_close(websocketpp::connection_hdl hdl)
                         {
-                            {
-                                std::lock_guard<std::mutex> lock(mutex);
-                                connections.erase(hdl);
-                            }
+                            erase_connection(hdl);
 
                             if (user_close)
                             {
@@ -634,7 +886,7 @@ namespace web
                             }
                         }
 
-                        std::thread thread;
+                        std::vector<std::thread> threads;
                         server_t server;
                         connections_t connections;
                         std::mutex mutex;
@@ -736,6 +988,11 @@ namespace web
                     return impl->send(connection, message);
                 }
 
+                connection_metrics websocket_listener::metrics(const connection_id& connection) const
+                {
+                    return impl->metrics(connection);
+                }
+
                 const web::uri& websocket_listener::uri() const
                 {
                     return impl->uri();
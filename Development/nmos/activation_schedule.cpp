@@ -0,0 +1,109 @@
+#include "nmos/activation_schedule.h"
+
+#include "nmos/activation_mode.h"
+#include "nmos/json_fields.h"
+#include "nmos/resources.h"
+#include "nmos/slog.h"
+#include "nmos/version.h"
+
+namespace nmos
+{
+    namespace details
+    {
+        activation_schedule::activation_schedule()
+            : since(nmos::tai_min())
+        {
+        }
+
+        // examine the resources modified since the previous update, and (re)schedule or unschedule their activations
+        void activation_schedule::update(const nmos::resources& resources, slog::base_gate& gate)
+        {
+            auto& by_updated = resources.get<nmos::tags::updated>();
+
+            // the updated index is ordered most recent first
+            const auto modified_end = by_updated.lower_bound(since);
+            for (auto it = by_updated.begin(); modified_end != it; ++it)
+            {
+                const auto& resource = *it;
+
+                unschedule(resource.id);
+
+                if (!resource.has_data()) continue;
+
+                // in the Channel Mapping API resources, only outputs have a staged activation
+                if (!resource.data.has_field(nmos::fields::endpoint_staged)) continue;
+
+                const std::pair<nmos::id, nmos::type> id_type{ resource.id, resource.type };
+
+                auto& staged = nmos::fields::endpoint_staged(resource.data);
+                auto& staged_activation = nmos::fields::activation(staged);
+                auto& staged_mode_or_null = nmos::fields::mode(staged_activation);
+
+                if (staged_mode_or_null.is_null()) continue;
+
+                const nmos::activation_mode staged_mode{ staged_mode_or_null.as_string() };
+
+                if (nmos::activation_modes::activate_scheduled_absolute == staged_mode ||
+                    nmos::activation_modes::activate_scheduled_relative == staged_mode)
+                {
+                    auto& staged_activation_time = nmos::fields::activation_time(staged_activation);
+                    schedule(nmos::time_point_from_tai(nmos::parse_version(staged_activation_time.as_string())), { id_type, false });
+                }
+                else if (nmos::activation_modes::activate_immediate == staged_mode)
+                {
+                    // check for cancelled in-flight immediate activation
+                    if (nmos::fields::requested_time(staged_activation).is_null()) continue;
+                    // check for processed in-flight immediate activation
+                    if (!nmos::fields::activation_time(staged_activation).is_null()) continue;
+
+                    // immediate activations are due straight away
+                    schedule((tai_clock::time_point::min)(), { id_type, true });
+                }
+                else
+                {
+                    slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Unexpected activation mode for " << id_type;
+                }
+            }
+
+            since = nmos::most_recent_update(resources);
+        }
+
+        // remove and return the activations that are due before the specified time, immediate activations first, then in time order
+        std::vector<activation_schedule::activation> activation_schedule::pop_due(const tai_clock::time_point& now)
+        {
+            std::vector<activation> due;
+
+            const auto due_end = queue.lower_bound({ now, {} });
+            for (auto it = queue.begin(); due_end != it; ++it)
+            {
+                auto found = scheduled.find(it->second);
+                due.push_back(found->second.second);
+                scheduled.erase(found);
+            }
+            queue.erase(queue.begin(), due_end);
+
+            return due;
+        }
+
+        // the time of the earliest pending activation, or time_point::max if there is none
+        tai_clock::time_point activation_schedule::next() const
+        {
+            return !queue.empty() ? queue.begin()->first : (tai_clock::time_point::max)();
+        }
+
+        void activation_schedule::unschedule(const nmos::id& id)
+        {
+            auto found = scheduled.find(id);
+            if (scheduled.end() == found) return;
+
+            queue.erase({ found->second.first, id });
+            scheduled.erase(found);
+        }
+
+        void activation_schedule::schedule(const tai_clock::time_point& due, const activation& activation)
+        {
+            queue.insert({ due, activation.id_type.first });
+            scheduled.insert({ activation.id_type.first, { due, activation } });
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef NMOS_ACTIVATION_SCHEDULE_H
+#define NMOS_ACTIVATION_SCHEDULE_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include "nmos/id.h"
+#include "nmos/tai.h"
+#include "nmos/type.h"
+
+namespace slog
+{
+    class base_gate;
+}
+
+namespace nmos
+{
+    struct resources;
+
+    namespace details
+    {
+        // An index of the pending immediate and scheduled activations of the resources in the Connection API or Channel Mapping API resources,
+        // so that the activation threads do not need to go through all the resources to find the due activations and the next scheduled one
+        // The schedule is brought up-to-date from the updated index, so only the resources which have been modified since the previous update
+        // (e.g. by a PATCH request to the staged endpoint, or by an activation) need to be examined
+        class activation_schedule
+        {
+        public:
+            struct activation
+            {
+                std::pair<nmos::id, nmos::type> id_type;
+                bool immediate;
+            };
+
+            activation_schedule();
+
+            // examine the resources modified since the previous update, and (re)schedule or unschedule their activations
+            void update(const nmos::resources& resources, slog::base_gate& gate);
+
+            // remove and return the activations that are due before the specified time, immediate activations first, then in time order
+            std::vector<activation> pop_due(const tai_clock::time_point& now);
+
+            // the time of the earliest pending activation, or time_point::max if there is none
+            tai_clock::time_point next() const;
+
+            bool empty() const { return queue.empty(); }
+            std::size_t size() const { return queue.size(); }
+
+        private:
+            void unschedule(const nmos::id& id);
+            void schedule(const tai_clock::time_point& due, const activation& activation);
+
+            nmos::tai since;
+
+            typedef std::pair<tai_clock::time_point, nmos::id> queue_key;
+            std::set<queue_key> queue;
+            std::map<nmos::id, std::pair<tai_clock::time_point, activation>> scheduled;
+        };
+    }
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "nmos/authorization_state.h"
 #include "nmos/authorization_utils.h"
 #include "nmos/is10_versions.h"
+#include "nmos/mdns_cache.h"
 #include "nmos/model.h"
 #include "nmos/random.h"
 #include "nmos/slog.h"
@@ -45,7 +46,7 @@ namespace nmos
         {
             nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::authorization_behaviour));
 
-            mdns::service_discovery discovery(gate);
+            mdns::service_discovery discovery(nmos::experimental::make_service_discovery(with_read_lock(model.mutex, [&] { return model.settings; }), gate));
 
             details::authorization_behaviour_thread(model, authorization_state, std::move(load_ca_certificates), std::move(load_rsa_private_keys), std::move(load_authorization_clients), std::move(save_authorization_client), std::move(request_authorization_code), discovery, gate);
         }
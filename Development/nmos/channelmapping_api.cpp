@@ -489,6 +489,8 @@ namespace nmos
 
             slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying channel mapping activation thread";
 
+            // notify every waiter, not only model.channelmapping_changes, since application threads may also wait for staged actions
+            // or activations on the model's condition
             model.notify();
 
             // Prepare the response
@@ -1,7 +1,6 @@
 #include "nmos/connection_activation.h"
 
-#include "detail/for_each_reversed.h"
-#include "nmos/activation_mode.h"
+#include "nmos/activation_schedule.h"
 #include "nmos/connection_api.h" // for nmos::set_connection_resource_active, etc.
 #include "nmos/model.h"
 #include "nmos/slog.h"
@@ -16,75 +15,44 @@ namespace nmos
         auto most_recent_update = nmos::tai_min();
         auto earliest_scheduled_activation = (nmos::tai_clock::time_point::max)();
 
+        // index of the pending immediate and scheduled activations
+        nmos::details::activation_schedule schedule;
+
         for (;;)
         {
             // wait for the thread to be interrupted because there may be new scheduled activations, or immediate activations to process
             // or because the server is being shut down
             // or because it's time for the next scheduled activation
-            model.wait_until(lock, earliest_scheduled_activation, [&] { return model.shutdown || most_recent_update < nmos::most_recent_update(model.connection_resources); });
+            model.wait_until(model.connection_changes, lock, earliest_scheduled_activation, [&] { return model.shutdown || most_recent_update < nmos::most_recent_update(model.connection_resources); });
             if (model.shutdown) break;
 
-            auto& by_updated = model.connection_resources.get<nmos::tags::updated>();
+            // bring the schedule up-to-date with any new, modified or cancelled activations
+            schedule.update(model.connection_resources, gate);
 
-            // go through all connection resources
             // process any immediate activations
             // process any scheduled activations whose requested_time has passed
             // identify the next scheduled activation
 
             const auto now = nmos::tai_clock::now();
 
-            earliest_scheduled_activation = (nmos::tai_clock::time_point::max)();
-
             bool notify = false;
 
-            // since modify reorders the resource in this index, use for_each_reversed
-            detail::for_each_reversed(by_updated.begin(), by_updated.end(), [&](const nmos::resource& resource)
+            for (const auto& due : schedule.pop_due(now))
             {
-                if (!resource.has_data()) return;
-
-                const std::pair<nmos::id, nmos::type> id_type{ resource.id, resource.type };
+                const auto& id_type = due.id_type;
 
-                auto& staged = nmos::fields::endpoint_staged(resource.data);
-                auto& staged_activation = nmos::fields::activation(staged);
-                auto& staged_mode_or_null = nmos::fields::mode(staged_activation);
+                auto found = find_resource(model.connection_resources, id_type);
+                if (model.connection_resources.end() == found || !found->has_data()) continue;
 
-                if (staged_mode_or_null.is_null()) return;
+                const nmos::resource& resource = *found;
 
-                const nmos::activation_mode staged_mode{ staged_mode_or_null.as_string() };
-
-                if (nmos::activation_modes::activate_scheduled_absolute == staged_mode ||
-                    nmos::activation_modes::activate_scheduled_relative == staged_mode)
+                if (due.immediate)
                 {
-                    auto& staged_activation_time = nmos::fields::activation_time(staged_activation);
-                    const auto scheduled_activation = nmos::time_point_from_tai(nmos::parse_version(staged_activation_time.as_string()));
-
-                    if (scheduled_activation < now)
-                    {
-                        slog::log<slog::severities::info>(gate, SLOG_FLF) << "Processing scheduled activation for " << id_type;
-                    }
-                    else
-                    {
-                        if (scheduled_activation < earliest_scheduled_activation)
-                        {
-                            earliest_scheduled_activation = scheduled_activation;
-                        }
-
-                        return;
-                    }
-                }
-                else if (nmos::activation_modes::activate_immediate == staged_mode)
-                {
-                    // check for cancelled in-flight immediate activation
-                    if (nmos::fields::requested_time(staged_activation).is_null()) return;
-                    // check for processed in-flight immediate activation
-                    if (!nmos::fields::activation_time(staged_activation).is_null()) return;
-
                     slog::log<slog::severities::info>(gate, SLOG_FLF) << "Processing immediate activation for " << id_type;
                 }
                 else
                 {
-                    slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Unexpected activation mode for " << id_type;
-                    return;
+                    slog::log<slog::severities::info>(gate, SLOG_FLF) << "Processing scheduled activation for " << id_type;
                 }
 
                 const auto activation_time = nmos::tai_now();
@@ -195,7 +163,9 @@ namespace nmos
                 }
 
                 notify = true;
-            });
+            }
+
+            earliest_scheduled_activation = schedule.next();
 
             if ((nmos::tai_clock::time_point::max)() != earliest_scheduled_activation)
             {
@@ -676,8 +676,10 @@ namespace nmos
 
         void notify_connection_resource_patch(const nmos::node_model& model, slog::base_gate& gate)
         {
-            slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying connection activation thread";
+            slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying connection activation thread"; // and anyone else who cares...
 
+            // notify every waiter, not only model.connection_changes, since application threads may also wait for staged parameters
+            // or activations on the model's condition
             model.notify();
         }
 
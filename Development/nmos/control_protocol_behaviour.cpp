@@ -37,6 +37,7 @@ namespace nmos
             auto& control_protocol_resources = model.control_protocol_resources;
 
             auto get_control_protocol_class_descriptor = nmos::make_get_control_protocol_class_descriptor_handler(state);
+            auto get_control_protocol_property_descriptor = nmos::make_get_control_protocol_property_descriptor_handler(state);
             auto get_monitor_domains = nmos::make_get_monitor_domains_handler(state);
             // continue until the server is being shut down
             for (;;)
@@ -74,7 +75,7 @@ namespace nmos
                             auto oid = nmos::fields::nc::oid(descriptor);
                             const auto& class_id = nc::details::parse_class_id(nmos::fields::nc::class_id(descriptor));
 
-                            auto status_reporting_delay = nc::get_property(control_protocol_resources, oid, nc_status_monitor_status_reporting_delay, get_control_protocol_class_descriptor, gate);
+                            auto status_reporting_delay = nc::get_property(control_protocol_resources, oid, nc_status_monitor_status_reporting_delay, get_control_protocol_property_descriptor, gate);
 
                             const auto domain_statuses = nmos::nc::get_monitor_domains(class_id, get_monitor_domains);
 
@@ -111,7 +112,7 @@ namespace nmos
                             const auto& oid = nmos::fields::nc::oid(descriptor);
                             const auto& class_id = nc::details::parse_class_id(nmos::fields::nc::class_id(descriptor));
 
-                            const auto status_reporting_delay = nc::get_property(control_protocol_resources, oid, nc_status_monitor_status_reporting_delay, get_control_protocol_class_descriptor, gate);
+                            const auto status_reporting_delay = nc::get_property(control_protocol_resources, oid, nc_status_monitor_status_reporting_delay, get_control_protocol_property_descriptor, gate);
 
                             const auto domain_statuses = nmos::nc::get_monitor_domains(class_id, get_monitor_domains);
 
@@ -40,32 +40,25 @@ namespace nmos
 
     get_control_protocol_method_descriptor_handler make_get_control_protocol_method_descriptor_handler(experimental::control_protocol_state& control_protocol_state)
     {
-        return [&](const nc_class_id& class_id_, const nc_method_id& method_id)
+        return [&](const nc_class_id& class_id, const nc_method_id& method_id)
         {
-            auto class_id = class_id_;
-
-            auto get_control_protocol_class_descriptor = make_get_control_protocol_class_descriptor_handler(control_protocol_state);
-
-            auto lock = control_protocol_state.read_lock();
-
-            while (!class_id.empty())
-            {
-                const auto& control_class_descriptor = get_control_protocol_class_descriptor(class_id);
-
-                auto& method_descriptors = control_class_descriptor.method_descriptors;
-                auto found = std::find_if(method_descriptors.begin(), method_descriptors.end(), [&method_id](const experimental::method& method)
-                {
-                    return method_id == nc::details::parse_method_id(nmos::fields::nc::id(std::get<0>(method)));
-                });
-                if (method_descriptors.end() != found)
-                {
-                    return *found;
-                }
+            return control_protocol_state.find_method_descriptor(class_id, method_id);
+        };
+    }
 
-                class_id.pop_back();
-            }
+    get_control_protocol_property_descriptor_handler make_get_control_protocol_property_descriptor_handler(experimental::control_protocol_state& control_protocol_state)
+    {
+        return [&](const nc_class_id& class_id, const nc_property_id& property_id)
+        {
+            return control_protocol_state.find_property_descriptor(class_id, property_id);
+        };
+    }
 
-            return experimental::method();
+    get_control_protocol_property_descriptor_handler make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor)
+    {
+        return [get_control_protocol_class_descriptor](const nc_class_id& class_id, const nc_property_id& property_id)
+        {
+            return nc::find_property_descriptor(property_id, class_id, get_control_protocol_class_descriptor);
         };
     }
 
@@ -113,21 +106,21 @@ namespace nmos
 
     get_control_protocol_property_handler make_get_control_protocol_property_handler(const resources& resources, experimental::control_protocol_state& control_protocol_state, slog::base_gate& gate)
     {
-        auto get_control_protocol_class_descriptor = nmos::make_get_control_protocol_class_descriptor_handler(control_protocol_state);
+        auto get_control_protocol_property_descriptor = nmos::make_get_control_protocol_property_descriptor_handler(control_protocol_state);
 
-        return [&resources, get_control_protocol_class_descriptor, &gate](nc_oid oid, const nc_property_id& property_id)
+        return [&resources, get_control_protocol_property_descriptor, &gate](nc_oid oid, const nc_property_id& property_id)
         {
-            return nc::get_property(resources, oid, property_id, get_control_protocol_class_descriptor, gate);
+            return nc::get_property(resources, oid, property_id, get_control_protocol_property_descriptor, gate);
         };
     }
 
     set_control_protocol_property_handler make_set_control_protocol_property_handler(resources& resources, experimental::control_protocol_state& control_protocol_state, slog::base_gate& gate)
     {
-        auto get_control_protocol_class_descriptor = nmos::make_get_control_protocol_class_descriptor_handler(control_protocol_state);
+        auto get_control_protocol_property_descriptor = nmos::make_get_control_protocol_property_descriptor_handler(control_protocol_state);
 
-        return [&resources, get_control_protocol_class_descriptor, &gate](nc_oid oid, const nc_property_id& property_id, const web::json::value& value)
+        return [&resources, get_control_protocol_property_descriptor, &gate](nc_oid oid, const nc_property_id& property_id, const web::json::value& value)
         {
-            return nc::set_property_and_notify(resources, oid, property_id, value, get_control_protocol_class_descriptor, gate);
+            return nc::set_property_and_notify(resources, oid, property_id, value, get_control_protocol_property_descriptor, gate);
         };
     }
 
@@ -79,6 +79,10 @@ namespace nmos
     // this callback should not throw exceptions
     typedef std::function<experimental::method(const nc_class_id& class_id, const nc_method_id& method_id)> get_control_protocol_method_descriptor_handler;
 
+    // callback to retrieve a specific property descriptor, including inherited properties, null if not found
+    // this callback should not throw exceptions
+    typedef std::function<web::json::value(const nc_class_id& class_id, const nc_property_id& property_id)> get_control_protocol_property_descriptor_handler;
+
     // construct callback to retrieve a specific control protocol class descriptor
     get_control_protocol_class_descriptor_handler make_get_control_protocol_class_descriptor_handler(experimental::control_protocol_state& control_protocol_state);
 
@@ -88,6 +92,12 @@ namespace nmos
     // construct callback to retrieve a specific method
     get_control_protocol_method_descriptor_handler make_get_control_protocol_method_descriptor_handler(experimental::control_protocol_state& control_protocol_state);
 
+    // construct callback to retrieve a specific property descriptor
+    get_control_protocol_property_descriptor_handler make_get_control_protocol_property_descriptor_handler(experimental::control_protocol_state& control_protocol_state);
+
+    // construct callback to retrieve a specific property descriptor by walking the class hierarchy using the specified class descriptor callback
+    get_control_protocol_property_descriptor_handler make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor);
+
     // Set monitor status to pending
     monitor_status_pending_handler make_monitor_status_pending_handler(experimental::control_protocol_state& control_protocol_state);
 
@@ -14,7 +14,7 @@ namespace nmos
     {
         // NcObject methods implementation
         // Get property value
-        web::json::value get(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        web::json::value get(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -23,7 +23,7 @@ namespace nmos
             slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Get property: " << property_id.serialize();
 
             // find the relevant nc_property_descriptor
-            const auto& property = nc::find_property_descriptor(details::parse_property_id(property_id), details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), details::parse_property_id(property_id));
             if (!property.is_null() && resource.data.has_field(nmos::fields::nc::name(property)))
             {
                 return details::make_method_result({is_deprecated ? nmos::nc_method_status::method_deprecated : nmos::fields::nc::is_deprecated(property) ? nc_method_status::property_deprecated : nc_method_status::ok}, resource.data.at(nmos::fields::nc::name(property)));
@@ -37,7 +37,7 @@ namespace nmos
         }
 
         // Set property value
-        web::json::value set(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        web::json::value set(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -48,7 +48,7 @@ namespace nmos
 
             // find the relevant nc_property_descriptor
             const auto property_id_ = details::parse_property_id(property_id);
-            const auto& property = nc::find_property_descriptor(property_id_, details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), property_id_);
             if (!property.is_null())
             {
                 if (nmos::fields::nc::is_read_only(property))
@@ -117,7 +117,7 @@ namespace nmos
         }
 
         // Get sequence item
-        web::json::value get_sequence_item(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        web::json::value get_sequence_item(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -127,7 +127,7 @@ namespace nmos
             slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Get sequence item: " << property_id.serialize() << " index: " << index;
 
             // find the relevant nc_property_descriptor
-            const auto& property = nc::find_property_descriptor(details::parse_property_id(property_id), details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), details::parse_property_id(property_id));
             if (!property.is_null())
             {
                 const auto& data = resource.data.at(nmos::fields::nc::name(property));
@@ -160,7 +160,7 @@ namespace nmos
         }
 
         // Set sequence item
-        web::json::value set_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        web::json::value set_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -172,7 +172,7 @@ namespace nmos
 
             // find the relevant nc_property_descriptor
             const auto property_id_ = details::parse_property_id(property_id);
-            const auto& property = nc::find_property_descriptor(property_id_, details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), property_id_);
             if (!property.is_null())
             {
                 if (nmos::fields::nc::is_read_only(property))
@@ -237,7 +237,7 @@ namespace nmos
         }
 
         // Add item to sequence
-        web::json::value add_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        web::json::value add_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -250,7 +250,7 @@ namespace nmos
 
             // find the relevant nc_property_descriptor
             const auto property_id_ = details::parse_property_id(property_id);
-            const auto& property = nc::find_property_descriptor(property_id_, details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), property_id_);
             if (!property.is_null())
             {
                 if (nmos::fields::nc::is_read_only(property))
@@ -309,7 +309,7 @@ namespace nmos
         }
 
         // Delete sequence item
-        web::json::value remove_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        web::json::value remove_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -319,7 +319,7 @@ namespace nmos
             slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Remove sequence item: " << property_id.serialize() << " index: " << index;
 
             // find the relevant nc_property_descriptor
-            const auto& property = nc::find_property_descriptor(details::parse_property_id(property_id), details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), details::parse_property_id(property_id));
             if (!property.is_null())
             {
                 if (nmos::fields::nc::is_read_only(property))
@@ -371,7 +371,7 @@ namespace nmos
         }
 
         // Get sequence length
-        web::json::value get_sequence_length(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        web::json::value get_sequence_length(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate)
         {
             // note, model mutex is already locked by the outer function, so access to control_protocol_resources is OK...
 
@@ -382,7 +382,7 @@ namespace nmos
             slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Get sequence length: " << property_id.serialize();
 
             // find the relevant nc_property_descriptor
-            const auto& property = nc::find_property_descriptor(details::parse_property_id(property_id), details::parse_class_id(nmos::fields::nc::class_id(resource.data)), get_control_protocol_class_descriptor);
+            const auto& property = get_control_protocol_property_descriptor(details::parse_class_id(nmos::fields::nc::class_id(resource.data)), details::parse_property_id(property_id));
             if (!property.is_null())
             {
                 if (!nmos::fields::nc::is_sequence(property))
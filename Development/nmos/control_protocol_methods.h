@@ -15,19 +15,47 @@ namespace nmos
     {
         // NcObject methods implementation
         // Get property value
-        web::json::value get(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate);
+        web::json::value get(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate);
+        inline web::json::value get(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        {
+            return get(resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), gate);
+        }
         // Set property value
-        web::json::value set(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        web::json::value set(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        inline web::json::value set(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        {
+            return set(resources, resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), get_control_protocol_datatype_descriptor, property_changed, gate);
+        }
         // Get sequence item
-        web::json::value get_sequence_item(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate);
+        web::json::value get_sequence_item(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate);
+        inline web::json::value get_sequence_item(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        {
+            return get_sequence_item(resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), gate);
+        }
         // Set sequence item
-        web::json::value set_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        web::json::value set_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        inline web::json::value set_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        {
+            return set_sequence_item(resources, resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), get_control_protocol_datatype_descriptor, property_changed, gate);
+        }
         // Add item to sequence
-        web::json::value add_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        web::json::value add_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        inline web::json::value add_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        {
+            return add_sequence_item(resources, resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), get_control_protocol_datatype_descriptor, property_changed, gate);
+        }
         // Delete sequence item
-        web::json::value remove_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        web::json::value remove_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate);
+        inline web::json::value remove_sequence_item(nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, control_protocol_property_changed_handler property_changed, slog::base_gate& gate)
+        {
+            return remove_sequence_item(resources, resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), property_changed, gate);
+        }
         // Get sequence length
-        web::json::value get_sequence_length(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate);
+        web::json::value get_sequence_length(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate);
+        inline web::json::value get_sequence_length(const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        {
+            return get_sequence_length(resource, arguments, is_deprecated, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), gate);
+        }
 
         // NcBlock methods implementation
         // Get descriptors of members of the block
@@ -1,5 +1,7 @@
 #include "nmos/control_protocol_state.h"
 
+#include <algorithm>
+
 #include "cpprest/http_utils.h"
 #include "nmos/control_protocol_methods.h"
 #include "nmos/control_protocol_resource.h"
@@ -205,53 +207,53 @@ namespace nmos
 
         namespace details
         {
-            nmos::experimental::control_protocol_method_handler make_nc_get_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor)
+            nmos::experimental::control_protocol_method_handler make_nc_get_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor)
             {
-                return [get_control_protocol_class_descriptor](nmos::resources&, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor](nmos::resources&, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::get(resource, arguments, is_deprecated, get_control_protocol_class_descriptor, gate);
+                    return nc::get(resource, arguments, is_deprecated, get_control_protocol_property_descriptor, gate);
                 };
             }
-            nmos::experimental::control_protocol_method_handler make_nc_set_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed)
+            nmos::experimental::control_protocol_method_handler make_nc_set_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed)
             {
-                return [get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::set(resources, resource, arguments, is_deprecated, get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed, gate);
+                    return nc::set(resources, resource, arguments, is_deprecated, get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed, gate);
                 };
             }
-            nmos::experimental::control_protocol_method_handler make_nc_get_sequence_item_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor)
+            nmos::experimental::control_protocol_method_handler make_nc_get_sequence_item_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor)
             {
-                return [get_control_protocol_class_descriptor](nmos::resources&, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor](nmos::resources&, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::get_sequence_item(resource, arguments, is_deprecated, get_control_protocol_class_descriptor, gate);
+                    return nc::get_sequence_item(resource, arguments, is_deprecated, get_control_protocol_property_descriptor, gate);
                 };
             }
-            nmos::experimental::control_protocol_method_handler make_nc_set_sequence_item_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed)
+            nmos::experimental::control_protocol_method_handler make_nc_set_sequence_item_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed)
             {
-                return [get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::set_sequence_item(resources, resource, arguments, is_deprecated, get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed, gate);
+                    return nc::set_sequence_item(resources, resource, arguments, is_deprecated, get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed, gate);
                 };
             }
-            nmos::experimental::control_protocol_method_handler make_nc_add_sequence_item_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed)
+            nmos::experimental::control_protocol_method_handler make_nc_add_sequence_item_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor_handler get_control_protocol_datatype_descriptor, control_protocol_property_changed_handler property_changed)
             {
-                return [get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::add_sequence_item(resources, resource, arguments, is_deprecated, get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed, gate);
+                    return nc::add_sequence_item(resources, resource, arguments, is_deprecated, get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed, gate);
                 };
             }
-            nmos::experimental::control_protocol_method_handler make_nc_remove_sequence_item_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, control_protocol_property_changed_handler property_changed)
+            nmos::experimental::control_protocol_method_handler make_nc_remove_sequence_item_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, control_protocol_property_changed_handler property_changed)
             {
-                return [get_control_protocol_class_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor, property_changed](nmos::resources& resources, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::remove_sequence_item(resources, resource, arguments, is_deprecated, get_control_protocol_class_descriptor, property_changed, gate);
+                    return nc::remove_sequence_item(resources, resource, arguments, is_deprecated, get_control_protocol_property_descriptor, property_changed, gate);
                 };
             }
-            nmos::experimental::control_protocol_method_handler make_nc_get_sequence_length_handler(get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor)
+            nmos::experimental::control_protocol_method_handler make_nc_get_sequence_length_handler(get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor)
             {
-                return [get_control_protocol_class_descriptor](nmos::resources&, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
+                return [get_control_protocol_property_descriptor](nmos::resources&, const nmos::resource& resource, const web::json::value& arguments, bool is_deprecated, slog::base_gate& gate)
                 {
-                    return nc::get_sequence_length(resource, arguments, is_deprecated, get_control_protocol_class_descriptor, gate);
+                    return nc::get_sequence_length(resource, arguments, is_deprecated, get_control_protocol_property_descriptor, gate);
                 };
             }
             nmos::experimental::control_protocol_method_handler make_nc_get_member_descriptors_handler()
@@ -383,6 +385,50 @@ namespace nmos
             }
         }
 
+        namespace details
+        {
+            // make the index of the property and method descriptors of the given class id, including inherited ones
+            static control_class_descriptor_index make_control_class_descriptor_index(const control_class_descriptors& control_class_descriptors, nc_class_id class_id)
+            {
+                control_class_descriptor_index index;
+
+                // walk from the class itself to NcObject, so that the descriptors of a derived class take precedence over those of its base classes
+                while (!class_id.empty())
+                {
+                    auto found = control_class_descriptors.find(class_id);
+                    if (control_class_descriptors.end() != found)
+                    {
+                        for (const auto& property_descriptor : found->second.property_descriptors.as_array())
+                        {
+                            index.property_descriptors.insert({ nc::details::parse_property_id(nmos::fields::nc::id(property_descriptor)), property_descriptor });
+                        }
+                        for (const auto& method : found->second.method_descriptors)
+                        {
+                            index.method_descriptors.insert({ nc::details::parse_method_id(nmos::fields::nc::id(method.first)), method });
+                        }
+                    }
+                    class_id.pop_back();
+                }
+
+                return index;
+            }
+
+            // update the indices of the given class id and all the classes derived from it, after the class descriptor has been inserted or erased
+            static void update_control_class_descriptor_indices(control_class_descriptor_indices& indices, const control_class_descriptors& control_class_descriptors, const nc_class_id& class_id)
+            {
+                indices.erase(class_id);
+
+                for (const auto& control_class_descriptor : control_class_descriptors)
+                {
+                    const auto& derived_class_id = control_class_descriptor.first;
+                    if (derived_class_id.size() >= class_id.size() && std::equal(class_id.begin(), class_id.end(), derived_class_id.begin()))
+                    {
+                        indices[derived_class_id] = make_control_class_descriptor_index(control_class_descriptors, derived_class_id);
+                    }
+                }
+            }
+        }
+
         control_protocol_state::control_protocol_state(control_protocol_property_changed_handler property_changed, create_validation_fingerprint_handler create_validation_fingerprint, validate_validation_fingerprint_handler validate_validation_fingerprint, get_read_only_modification_allow_list_handler get_read_only_modification_allow_list, remove_device_model_object_handler remove_device_model_object, create_device_model_object_handler create_device_model_object, get_packet_counters_handler get_lost_packet_counters, get_packet_counters_handler get_late_packet_counters, reset_monitor_handler reset_monitor)
         : monitor_status_pending(false)
         {
@@ -413,6 +459,7 @@ namespace nmos
             };
 
             auto get_control_protocol_class_descriptor = make_get_control_protocol_class_descriptor_handler(*this);
+            auto get_control_protocol_property_descriptor = make_get_control_protocol_property_descriptor_handler(*this);
             auto get_monitor_domains = make_get_monitor_domains_handler(*this);
             auto get_control_protocol_datatype_descriptor = make_get_control_protocol_datatype_descriptor_handler(*this);
 
@@ -430,13 +477,13 @@ namespace nmos
                     to_methods_vector(nc::make_object_methods(),
                     {
                         // link NcObject method_ids with method functions
-                        { nc_object_get_method_id, details::make_nc_get_handler(get_control_protocol_class_descriptor) },
-                        { nc_object_set_method_id, details::make_nc_set_handler(get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed) },
-                        { nc_object_get_sequence_item_method_id, details::make_nc_get_sequence_item_handler(get_control_protocol_class_descriptor) },
-                        { nc_object_set_sequence_item_method_id, details::make_nc_set_sequence_item_handler(get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed) },
-                        { nc_object_add_sequence_item_method_id, details::make_nc_add_sequence_item_handler(get_control_protocol_class_descriptor, get_control_protocol_datatype_descriptor, property_changed) },
-                        { nc_object_remove_sequence_item_method_id, details::make_nc_remove_sequence_item_handler(get_control_protocol_class_descriptor, property_changed) },
-                        { nc_object_get_sequence_length_method_id, details::make_nc_get_sequence_length_handler(get_control_protocol_class_descriptor) }
+                        { nc_object_get_method_id, details::make_nc_get_handler(get_control_protocol_property_descriptor) },
+                        { nc_object_set_method_id, details::make_nc_set_handler(get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed) },
+                        { nc_object_get_sequence_item_method_id, details::make_nc_get_sequence_item_handler(get_control_protocol_property_descriptor) },
+                        { nc_object_set_sequence_item_method_id, details::make_nc_set_sequence_item_handler(get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed) },
+                        { nc_object_add_sequence_item_method_id, details::make_nc_add_sequence_item_handler(get_control_protocol_property_descriptor, get_control_protocol_datatype_descriptor, property_changed) },
+                        { nc_object_remove_sequence_item_method_id, details::make_nc_remove_sequence_item_handler(get_control_protocol_property_descriptor, property_changed) },
+                        { nc_object_get_sequence_length_method_id, details::make_nc_get_sequence_length_handler(get_control_protocol_property_descriptor) }
                     }),
                     // NcObject events
                     to_vector(nc::make_object_events())) },
@@ -655,6 +702,11 @@ namespace nmos
                 { U("NcMethodResultBulkPropertiesHolder"), {nc::make_method_result_bulk_properties_holder_datatype()} },
                 { U("NcMethodResultObjectPropertiesSetValidation"), {nc::make_method_result_object_properties_set_validation_datatype()} }
             };
+
+            for (const auto& control_class_descriptor : control_class_descriptors)
+            {
+                control_class_descriptor_indices[control_class_descriptor.first] = details::make_control_class_descriptor_index(control_class_descriptors, control_class_descriptor.first);
+            }
         }
 
         // insert control class descriptor, false if class descriptor already inserted
@@ -665,6 +717,7 @@ namespace nmos
             if (control_class_descriptors.end() == control_class_descriptors.find(control_class_descriptor.class_id))
             {
                 control_class_descriptors[control_class_descriptor.class_id] = control_class_descriptor;
+                details::update_control_class_descriptor_indices(control_class_descriptor_indices, control_class_descriptors, control_class_descriptor.class_id);
                 return true;
             }
             return false;
@@ -678,11 +731,54 @@ namespace nmos
             if (control_class_descriptors.end() != control_class_descriptors.find(class_id))
             {
                 control_class_descriptors.erase(class_id);
+                details::update_control_class_descriptor_indices(control_class_descriptor_indices, control_class_descriptors, class_id);
                 return true;
             }
             return false;
         }
 
+        // find the property descriptor of the given class id, including inherited properties, null if not found
+        web::json::value control_protocol_state::find_property_descriptor(const nc_class_id& class_id_, const nc_property_id& property_id) const
+        {
+            auto lock = read_lock();
+
+            // the class itself may not have been inserted, in which case its nearest base class is used
+            auto class_id = class_id_;
+            while (!class_id.empty())
+            {
+                auto found = control_class_descriptor_indices.find(class_id);
+                if (control_class_descriptor_indices.end() != found)
+                {
+                    auto& property_descriptors = found->second.property_descriptors;
+                    auto found_property = property_descriptors.find(property_id);
+                    return property_descriptors.end() != found_property ? found_property->second : web::json::value::null();
+                }
+                class_id.pop_back();
+            }
+            return web::json::value::null();
+        }
+
+        // find the method of the given class id, including inherited methods, empty if not found
+        experimental::method control_protocol_state::find_method_descriptor(const nc_class_id& class_id_, const nc_method_id& method_id) const
+        {
+            auto lock = read_lock();
+
+            // the class itself may not have been inserted, in which case its nearest base class is used
+            auto class_id = class_id_;
+            while (!class_id.empty())
+            {
+                auto found = control_class_descriptor_indices.find(class_id);
+                if (control_class_descriptor_indices.end() != found)
+                {
+                    auto& method_descriptors = found->second.method_descriptors;
+                    auto found_method = method_descriptors.find(method_id);
+                    return method_descriptors.end() != found_method ? found_method->second : experimental::method();
+                }
+                class_id.pop_back();
+            }
+            return experimental::method();
+        }
+
         // insert datatype descriptor, false if datatype descriptor already inserted
         bool control_protocol_state::insert(const experimental::datatype_descriptor& datatype_descriptor)
         {
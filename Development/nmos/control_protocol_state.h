@@ -2,6 +2,7 @@
 #define NMOS_CONTROL_PROTOCOL_STATE_H
 
 #include <map>
+#include <unordered_map>
 #include "bst/optional.h"
 #include "cpprest/json_utils.h"
 #include "nmos/configuration_handlers.h"
@@ -87,6 +88,24 @@ namespace nmos
         };
 
         typedef std::map<nmos::nc_class_id, control_class_descriptor> control_class_descriptors;
+
+        namespace details
+        {
+            struct nc_element_id_hash
+            {
+                size_t operator()(const nc_element_id& id) const { return (size_t(id.level) << 16) | id.index; }
+            };
+        }
+
+        // the property and method descriptors of a control class, including those inherited from its base classes, by id
+        // so that these can be found without walking the class hierarchy and parsing the id of every descriptor at each level
+        struct control_class_descriptor_index
+        {
+            std::unordered_map<nc_property_id, web::json::value, details::nc_element_id_hash> property_descriptors;
+            std::unordered_map<nc_method_id, method, details::nc_element_id_hash> method_descriptors;
+        };
+
+        typedef std::map<nmos::nc_class_id, control_class_descriptor_index> control_class_descriptor_indices;
         typedef std::map<nmos::nc_name, datatype_descriptor> datatype_descriptors;
         typedef std::map<nmos::nc_class_id, std::vector<monitor_domain>> monitor_domain_profiles;
 
@@ -99,7 +118,9 @@ namespace nmos
             // false: no more receiver/sender monitors statuses are pending
             bool monitor_status_pending;
 
+            // control class descriptors should be inserted and erased using the functions below, which also maintain the index
             experimental::control_class_descriptors control_class_descriptors;
+            experimental::control_class_descriptor_indices control_class_descriptor_indices;
             experimental::datatype_descriptors datatype_descriptors;
             experimental::monitor_domain_profiles monitor_domain_profiles;
 
@@ -112,6 +133,11 @@ namespace nmos
             // erase control class of the given class id, false if the required class not found
             bool erase(nc_class_id class_id);
 
+            // find the property descriptor of the given class id, including inherited properties, null if not found
+            web::json::value find_property_descriptor(const nc_class_id& class_id, const nc_property_id& property_id) const;
+            // find the method of the given class id, including inherited methods, empty if not found
+            experimental::method find_method_descriptor(const nc_class_id& class_id, const nc_method_id& method_id) const;
+
             // insert datatype descriptor, false if datatype descriptor already inserted
             bool insert(const experimental::datatype_descriptor& datatype_descriptor);
             // erase datatype descriptor of the given datatype name, false if the required datatype descriptor not found
@@ -832,6 +832,95 @@ namespace nmos
             nc_block_resource.resources.push_back(resource);
         }
 
+        namespace details
+        {
+            // remove the control protocol object of the given oid from the indices
+            static void erase_control_protocol_object(resources& resources, nc_oid oid)
+            {
+                auto& index = resources.control_protocol_objects;
+
+                const auto found = index.objects.find(oid);
+                if (index.objects.end() == found) return;
+
+                const auto& object = found->second;
+                if (object.has_owner)
+                {
+                    auto members = index.members.find(object.owner);
+                    if (index.members.end() != members)
+                    {
+                        auto member = members->second.find(object.role);
+                        if (members->second.end() != member && oid == member->second)
+                        {
+                            members->second.erase(member);
+                        }
+                        if (members->second.empty())
+                        {
+                            index.members.erase(members);
+                        }
+                    }
+                }
+
+                for (const auto& touchpoint : object.touchpoints)
+                {
+                    const auto range = index.touchpoints.equal_range(touchpoint);
+                    for (auto it = range.first; range.second != it;)
+                    {
+                        if (oid == it->second)
+                        {
+                            it = index.touchpoints.erase(it);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+                }
+
+                index.objects.erase(found);
+            }
+
+            // add the control protocol object to the indices, replacing any previous object with the same oid
+            static void insert_control_protocol_object(resources& resources, const resource& resource)
+            {
+                const auto& data = resource.data;
+                if (!data.has_field(nmos::fields::nc::oid)) return;
+
+                const nc_oid oid = nmos::fields::nc::oid(data);
+                erase_control_protocol_object(resources, oid);
+
+                nmos::details::control_protocol_objects::object object;
+                object.id = resource.id;
+                const auto& owner = data.has_field(nmos::fields::nc::owner) ? data.at(nmos::fields::nc::owner) : web::json::value::null();
+                object.has_owner = owner.is_integer();
+                object.owner = object.has_owner ? nc_oid(owner.as_integer()) : 0;
+                if (data.has_field(nmos::fields::nc::role)) object.role = nmos::fields::nc::role(data);
+
+                const auto& touchpoints = data.has_field(nmos::fields::nc::touchpoints) ? data.at(nmos::fields::nc::touchpoints) : web::json::value::null();
+                if (touchpoints.is_array())
+                {
+                    for (const auto& touchpoint : touchpoints.as_array())
+                    {
+                        const auto& touchpoint_resource = nmos::fields::nc::resource(touchpoint);
+                        if (touchpoint_resource.has_field(nmos::fields::nc::id) && touchpoint_resource.at(nmos::fields::nc::id).is_string())
+                        {
+                            object.touchpoints.push_back(nmos::fields::nc::id(touchpoint_resource).as_string());
+                        }
+                    }
+                }
+
+                auto& index = resources.control_protocol_objects;
+                if (object.has_owner)
+                {
+                    index.members[object.owner][object.role] = oid;
+                }
+                for (const auto& touchpoint : object.touchpoints)
+                {
+                    index.touchpoints.insert({ touchpoint, oid });
+                }
+                index.objects.insert({ oid, std::move(object) });
+            }
+        }
+
         // insert root block and all sub control protocol resources
         void insert_root(resources& resources, control_protocol_resource& root)
         {
@@ -867,6 +956,10 @@ namespace nmos
                 // if the insertion was banned, resource has not been moved from
                 result.second = resources.replace(result.first, std::move(resource));
             }
+            if (result.second)
+            {
+                details::insert_control_protocol_object(resources, *result.first);
+            }
             return result;
         }
 
@@ -924,15 +1017,43 @@ namespace nmos
             auto found = resources.find(id);
             if (resources.end() != found && found->has_data())
             {
+                if (found->data.has_field(nmos::fields::nc::oid))
+                {
+                    details::erase_control_protocol_object(resources, nmos::fields::nc::oid(found->data));
+                }
                 resources.erase(found);
                 ++count;
             }
             return count;
         }
 
+        // find the control protocol resource of the given oid
+        resources::const_iterator find_resource(const resources& resources, nc_oid oid)
+        {
+            const auto& objects = resources.control_protocol_objects.objects;
+            const auto found = objects.find(oid);
+            return nmos::find_resource(resources, objects.end() != found ? found->second.id : utility::s2us(std::to_string(oid)));
+        }
+
         // find the control protocol resource which is assoicated with the given IS-04/IS-05/IS-08 resource id
         resources::const_iterator find_resource(resources& resources, type type, const id& resource_id)
         {
+            const auto& index = resources.control_protocol_objects;
+            if (!index.objects.empty())
+            {
+                // the device model has been inserted using nc::insert_resource, so use the touchpoint index
+                const auto range = index.touchpoints.equal_range(resource_id);
+                for (auto it = range.first; range.second != it; ++it)
+                {
+                    const auto found = find_resource(resources, it->second);
+                    if (resources.end() != found && found->has_data() && type == found->type)
+                    {
+                        return found;
+                    }
+                }
+                return resources.end();
+            }
+
             return find_resource_if(resources, type, [resource_id](const nmos::resource& resource)
                 {
                     auto& touchpoints = resource.data.at(nmos::fields::nc::touchpoints);
@@ -991,6 +1112,34 @@ namespace nmos
 
         resources::const_iterator find_resource_by_role_path(const resources& resources, const web::json::array& role_path_)
         {
+            const auto& index = resources.control_protocol_objects;
+            if (!index.objects.empty())
+            {
+                // the device model has been inserted using nc::insert_resource, so use the role path trie
+                // rather than walking the block member descriptors
+                if (0 == role_path_.size() || !web::json::front(role_path_).is_string()) return resources.end();
+
+                nc_oid oid = nmos::root_block_oid;
+                auto found = find_resource(resources, oid);
+                if (resources.end() == found || !found->has_data() || nmos::fields::nc::role(found->data) != web::json::front(role_path_).as_string()) return resources.end();
+
+                for (auto role = std::next(role_path_.begin()); role_path_.end() != role; ++role)
+                {
+                    // the members of a block which has been erased are no longer found
+                    if (!role->is_string() || index.objects.end() == index.objects.find(oid)) return resources.end();
+
+                    const auto members = index.members.find(oid);
+                    if (index.members.end() == members) return resources.end();
+                    const auto member = members->second.find(role->as_string());
+                    if (members->second.end() == member) return resources.end();
+
+                    oid = member->second;
+                }
+
+                found = find_resource(resources, oid);
+                return resources.end() != found && found->has_data() ? found : resources.end();
+            }
+
             auto role_path = role_path_;
             auto resource = nmos::find_resource(resources, utility::s2us(std::to_string(nmos::root_block_oid)));
             if (resources.end() != resource)
@@ -1057,21 +1206,20 @@ namespace nmos
 
             if (pre == post) return;
 
-            auto& by_type = resources.get<tags::type>();
-            const auto subscriptions = by_type.equal_range(nmos::details::has_data(nmos::types::subscription));
-
-            for (auto it = subscriptions.first; subscriptions.second != it; ++it)
+            // only the candidate subscriptions need to be evaluated
+            for (const auto& subscription_id : nmos::details::get_candidate_subscriptions(resources, type, pre, post))
             {
                 // for each subscription
+                auto it = nmos::find_resource(resources, { subscription_id, nmos::types::subscription });
+                if (resources.end() == it) continue;
                 const auto& subscription = *it;
 
                 // check whether the resource_path matches the resource type and the query parameters match either the "pre" or "post" resource
 
-                const auto resource_path = nmos::fields::resource_path(subscription.data);
-                const resource_query match(subscription.version, resource_path, nmos::fields::params(subscription.data));
+                const auto match = nmos::details::get_subscription_query(resources, subscription);
 
-                const bool pre_match = match(version, downgrade_version, type, pre, resources);
-                const bool post_match = match(version, downgrade_version, type, post, resources);
+                const bool pre_match = (*match)(version, downgrade_version, type, pre, resources);
+                const bool post_match = (*match)(version, downgrade_version, type, post, resources);
 
                 if (!pre_match && !post_match) continue;
 
@@ -1092,14 +1240,14 @@ namespace nmos
             }
         }
 
-        web::json::value get_property(const resources& resources, nc_oid oid, const nc_property_id& property_id, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        web::json::value get_property(const resources& resources, nc_oid oid, const nc_property_id& property_id, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate)
         {
             // get resource based on the oid
             const auto found = find_resource(resources, utility::s2us(std::to_string(oid)));
             if (resources.end() != found)
             {
                 // find the relevant nc_property_descriptor
-                const auto& property = nc::find_property_descriptor(property_id, nc::details::parse_class_id(nmos::fields::nc::class_id(found->data)), get_control_protocol_class_descriptor);
+                const auto& property = get_control_protocol_property_descriptor(nc::details::parse_class_id(nmos::fields::nc::class_id(found->data)), property_id);
                 if (!property.is_null() && found->has_data() && found->data.has_field(nmos::fields::nc::name(property)))
                 {
                     return found->data.at(nmos::fields::nc::name(property));
@@ -1110,12 +1258,12 @@ namespace nmos
             return web::json::value::null();
         }
 
-        bool set_property_and_notify(resources& resources, nc_oid oid, const nc_property_id& property_id, const web::json::value& value, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        bool set_property_and_notify(resources& resources, nc_oid oid, const nc_property_id& property_id, const web::json::value& value, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate)
         {
             const auto found = find_resource(resources, utility::s2us(std::to_string(oid)));
             if (resources.end() != found)
             {
-                const auto& property = nc::find_property_descriptor(property_id, nc::details::parse_class_id(nmos::fields::nc::class_id(found->data)), get_control_protocol_class_descriptor);
+                const auto& property = get_control_protocol_property_descriptor(nc::details::parse_class_id(nmos::fields::nc::class_id(found->data)), property_id);
                 if (!property.is_null())
                 {
                     try
@@ -101,6 +101,9 @@ namespace nmos
         // erase a control protocol resource
         resources::size_type erase_resource(resources& resources, const id& id);
 
+        // find the control protocol resource of the given oid
+        resources::const_iterator find_resource(const resources& resources, nc_oid oid);
+
         // find the control protocol resource which is associated with the given IS-04/IS-05/IS-08 resource id
         resources::const_iterator find_resource(resources& resources, type type, const id& id);
 
@@ -122,10 +125,18 @@ namespace nmos
         void insert_notification_events(resources& resources, const api_version& version, const api_version& downgrade_version, const type& type, const web::json::value& pre, const web::json::value& post, const web::json::value& event);
 
         // get property value given oid and property_id
-        web::json::value get_property(const resources& resources, nc_oid oid, const nc_property_id& property_id, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate);
+        web::json::value get_property(const resources& resources, nc_oid oid, const nc_property_id& property_id, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate);
+        inline web::json::value get_property(const resources& resources, nc_oid oid, const nc_property_id& property_id, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        {
+            return get_property(resources, oid, property_id, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), gate);
+        }
 
         // set property value given oid and property_id and notify
-        bool set_property_and_notify(resources& resources, nc_oid oid, const nc_property_id& property_id, const web::json::value& value, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate);
+        bool set_property_and_notify(resources& resources, nc_oid oid, const nc_property_id& property_id, const web::json::value& value, get_control_protocol_property_descriptor_handler get_control_protocol_property_descriptor, slog::base_gate& gate);
+        inline bool set_property_and_notify(resources& resources, nc_oid oid, const nc_property_id& property_id, const web::json::value& value, get_control_protocol_class_descriptor_handler get_control_protocol_class_descriptor, slog::base_gate& gate)
+        {
+            return set_property_and_notify(resources, oid, property_id, value, make_get_control_protocol_property_descriptor_handler(get_control_protocol_class_descriptor), gate);
+        }
 
         // set hidden property but don't notify, as property isn't part of class definition
         bool set_property(resources& resources, nc_oid oid, const utility::string_t& property_name, const web::json::value& value, slog::base_gate& gate);
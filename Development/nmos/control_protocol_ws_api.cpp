@@ -140,8 +140,8 @@ namespace nmos
 
                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Creating websocket connection: " << id << " to subscription: " << subscription->id;
 
-                slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying control protocol websockets thread"; // and anyone else who cares...
-                model.notify();
+                slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying control protocol websockets thread";
+                model.notify(model.control_protocol_changes);
             }
         };
     }
@@ -183,7 +183,7 @@ namespace nmos
 
                 websockets.right.erase(websocket);
 
-                model.notify();
+                model.notify(model.control_protocol_changes);
             }
         };
     }
@@ -353,7 +353,7 @@ namespace nmos
                                 });
 
                                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Received subscription command for " << valid_subscriptions.serialize();
-                                model.notify();
+                                model.notify(model.control_protocol_changes);
                             }
                             break;
                             default:
@@ -437,7 +437,6 @@ namespace nmos
 
         // could start out as a shared/read lock, only upgraded to an exclusive/write lock when a grain in the resources is actually modified
         auto lock = model.write_lock();
-        auto& condition = model.condition;
         auto& shutdown = model.shutdown;
         auto& resources = model.control_protocol_resources;
 
@@ -448,7 +447,7 @@ namespace nmos
         {
             // wait for the thread to be interrupted either because there are resource changes, or because the server is being shut down
             // or because message sending was throttled earlier
-            details::wait_until(condition, lock, earliest_necessary_update, [&] { return shutdown || most_recent_message < most_recent_update(resources); });
+            model.wait_until(model.control_protocol_changes, lock, earliest_necessary_update, [&] { return shutdown || most_recent_message < most_recent_update(resources); });
             if (shutdown) break;
             most_recent_message = most_recent_update(resources);
 
@@ -525,12 +524,10 @@ namespace nmos
             for (auto& outgoing_message : outgoing_messages)
             {
                 // hmmm, no way to cancel this currently...
-
-                auto send = listener.send(outgoing_message.first, outgoing_message.second)
-                    .then(details::observe_websocket_exception(gate));
-                // current websocket_listener implementation is synchronous in any case, but just to make clear...
-                // for now, wait for the message to be sent
-                send.wait();
+                // don't wait for the message to be sent, since that may be delayed if the connection is congested, which mustn't hold up other connections
+                // the exception is observed using the underlying gate, since this thread's gate may not outlive the send
+                listener.send(outgoing_message.first, outgoing_message.second)
+                    .then(details::observe_websocket_exception(gate_));
             }
         }
     }
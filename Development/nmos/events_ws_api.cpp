@@ -14,6 +14,7 @@
 #include "nmos/scope.h"
 #include "nmos/slog.h"
 #include "nmos/version.h"
+#include "nmos/ws_api_utils.h"
 
 namespace nmos
 {
@@ -139,8 +140,8 @@ namespace nmos
 
                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Creating websocket connection: " << id << " to subscription: " << subscription->id;
 
-                slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying events websockets thread"; // and anyone else who cares...
-                model.notify();
+                slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying events websockets thread";
+                model.notify(model.events_changes);
             }
         };
     }
@@ -182,7 +183,7 @@ namespace nmos
 
                 websockets.right.erase(websocket);
 
-                model.notify();
+                model.notify(model.events_changes);
             }
         };
     }
@@ -238,11 +239,9 @@ namespace nmos
 
                                 resources.modify(grain, [&](nmos::resource& grain)
                                 {
-                                    const auto& resource_path = nmos::fields::resource_path(subscription->data);
-                                    const auto& params = nmos::fields::params(subscription->data);
                                     // these resource events are not structured as required for the state message
                                     // so will be transformed in nmos::send_events_ws_messages_thread
-                                    auto events = make_resource_events(resources, subscription->version, resource_path, params);
+                                    auto events = make_resource_events(resources, *details::get_subscription_query(resources, *subscription));
 
                                     auto& events_storage = web::json::storage_of(events.as_array());
                                     auto& grain_storage = web::json::storage_of(nmos::fields::message_grain_data(grain.data).as_array());
@@ -258,7 +257,7 @@ namespace nmos
                                 });
 
                                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Received subscription command for " << nmos::fields::sources(message).size() << " sources";
-                                model.notify();
+                                model.notify(model.events_changes);
                             }
                             else if (U("health") == command)
                             {
@@ -280,7 +279,7 @@ namespace nmos
                                 });
 
                                 slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Received health command";
-                                model.notify();
+                                model.notify(model.events_changes);
                             }
                         }
                         catch (const web::json::json_exception& e)
@@ -365,20 +364,21 @@ namespace nmos
 
         // could start out as a shared/read lock, only upgraded to an exclusive/write lock when a grain in the resources is actually modified
         auto lock = model.write_lock();
-        auto& condition = model.condition;
         auto& shutdown = model.shutdown;
         auto& resources = model.events_resources;
 
         tai most_recent_message{};
+        std::uint64_t most_recent_event_count = 0;
         auto earliest_necessary_update = (tai_clock::time_point::max)();
 
         for (;;)
         {
-            // wait for the thread to be interrupted either because there are resource changes, or because the server is being shut down
+            // wait for the thread to be interrupted either because there are resource changes or events, or because the server is being shut down
             // or because message sending was throttled earlier
-            details::wait_until(condition, lock, earliest_necessary_update, [&] { return shutdown || most_recent_message < most_recent_update(resources); });
+            model.wait_until(model.events_changes, lock, earliest_necessary_update, [&] { return shutdown || most_recent_message < most_recent_update(resources) || most_recent_event_count < resources.grain_events.count; });
             if (shutdown) break;
             most_recent_message = most_recent_update(resources);
+            most_recent_event_count = resources.grain_events.count;
 
             slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Got notification on events websockets thread";
 
@@ -386,6 +386,12 @@ namespace nmos
 
             std::vector<std::pair<web::websockets::experimental::listener::connection_id, web::websockets::websocket_outgoing_message>> outgoing_messages;
 
+            // identical state messages, i.e. for the same source on many subscriptions, are only serialized once
+            details::serialization_cache serialized_states;
+            // so the events taken from the grains must outlive the cache (and reserving space ensures they are never moved)
+            std::vector<value> taken_events;
+            taken_events.reserve(websockets.size());
+
             for (auto wit = websockets.left.begin(); websockets.left.end() != wit;)
             {
                 const auto& websocket = *wit;
@@ -417,15 +423,18 @@ namespace nmos
                     continue;
                 }
                 // and has events to send
-                if (0 == nmos::fields::message_grain_data(grain->data).size())
+                if (0 == nmos::count_resource_events(resources, *grain))
                 {
                     ++wit;
                     continue;
                 }
 
-                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Preparing to send " << nmos::fields::message_grain_data(grain->data).size() << " events on websocket connection: " << grain->id;
+                taken_events.push_back(nmos::take_resource_events(resources, grain));
+                const auto& events = taken_events.back();
+
+                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Preparing to send " << events.size() << " events on websocket connection: " << grain->id;
 
-                for (const auto& event : nmos::fields::message_grain_data(grain->data).as_array())
+                for (const auto& event : events.as_array())
                 {
                     web::websockets::websocket_outgoing_message message;
 
@@ -442,22 +451,16 @@ namespace nmos
                         // and nmos::make_events_boolean_state, nmos::make_events_number_state, etc.
                         // and nmos::details::make_resource_event
                         const web::json::value& state = nmos::fields::endpoint_state(event.at(U("post")));
-                        message.set_utf8_message(utility::us2s(state.serialize()));
+                        message.set_utf8_message(*serialized_states.serialize(state, event.at(U("path")).as_string()));
                         outgoing_messages.push_back({ websocket.second, message });
                     }
                 }
 
-                // reset the grain for next time
-                resources.modify(grain, [&resources](nmos::resource& grain)
-                {
-                    // all messages have now been prepared
-                    nmos::fields::message_grain_data(grain.data) = value::array();
-                    grain.updated = strictly_increasing_update(resources);
-                });
-
                 ++wit;
             }
 
+            if (0 != serialized_states.hits()) slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Reused the serialized state for " << serialized_states.hits() << " websocket messages";
+
             // send the messages without the lock on resources
             details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
 
@@ -466,11 +469,10 @@ namespace nmos
             for (auto& outgoing_message : outgoing_messages)
             {
                 // hmmm, no way to cancel this currently...
-                auto send = listener.send(outgoing_message.first, outgoing_message.second)
-                    .then(details::observe_websocket_exception(gate));
-                // current websocket_listener implementation is synchronous in any case, but just to make clear...
-                // for now, wait for the message to be sent
-                send.wait();
+                // don't wait for the message to be sent, since that may be delayed if the connection is congested, which mustn't hold up other connections
+                // the exception is observed using the underlying gate, since this thread's gate may not outlive the send
+                listener.send(outgoing_message.first, outgoing_message.second)
+                    .then(details::observe_websocket_exception(gate_));
             }
         }
     }
@@ -527,8 +529,8 @@ namespace nmos
                     {
                         slog::log<slog::severities::info>(gate, SLOG_FLF) << expired << " resources have expired";
 
-                        slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying events websockets thread"; // and anyone else who cares...
-                        model.notify();
+                        slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying events websockets thread";
+                        model.notify(model.events_changes);
                     }
 
                     least_health = nmos::least_health(resources);
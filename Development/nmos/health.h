@@ -1,6 +1,8 @@
 #ifndef NMOS_HEALTH_H
 #define NMOS_HEALTH_H
 
+#include <memory>
+#include "nmos/copyable_atomic.h"
 #include "nmos/tai.h"
 
 namespace nmos
@@ -21,6 +23,48 @@ namespace nmos
     {
         return tai_clock::time_point(bst::chrono::seconds(health));
     }
+
+    namespace details
+    {
+        // The health of a resource is either its own, or is inherited from another resource, usually its super-resource,
+        // by sharing the same cell, so that a heartbeat for a node is a single atomic store, however many sub-resources it has
+        // Copying makes an independent cell with the current health, and so does assigning a health, i.e. setting the health
+        // of one resource never modifies the health of its super-resource
+        // Making a cell inherit another is thread-safe, but should be done with an exclusive/write lock on the resources
+        // when possible, since e.g. nmos::set_resource_health relies on the subtree_inherits flag being accurate
+        class health_cell
+        {
+        public:
+            health_cell() : subtree_inherits(false), cell(std::make_shared<copyable_atomic<health>>(0)) {}
+            explicit health_cell(health health) : subtree_inherits(false), cell(std::make_shared<copyable_atomic<nmos::health>>(health)) {}
+
+            health_cell(const health_cell& other) : health_cell(other.load()) {}
+            health_cell& operator=(const health_cell& other) { if (this != &other) *this = other.load(); return *this; }
+
+            health_cell& operator=(health health)
+            {
+                std::atomic_store(&cell, std::make_shared<copyable_atomic<nmos::health>>(health));
+                subtree_inherits = false;
+                return *this;
+            }
+
+            health load() const { return std::atomic_load(&cell)->load(); }
+            operator health() const { return load(); }
+
+            // set the health of this cell, i.e. also of every resource which inherits it
+            void store(health health) { std::atomic_load(&cell)->store(health); }
+
+            // inherit the health of the specified cell
+            void inherit(const health_cell& other) { std::atomic_store(&cell, std::atomic_load(&other.cell)); }
+            bool inherits(const health_cell& other) const { return std::atomic_load(&cell) == std::atomic_load(&other.cell); }
+
+            // whether all the sub-resources of the resource are known to inherit this health
+            std::atomic<bool> subtree_inherits;
+
+        private:
+            std::shared_ptr<copyable_atomic<health>> cell;
+        };
+    }
 }
 
 #endif
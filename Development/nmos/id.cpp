@@ -1,5 +1,6 @@
 #include "nmos/id.h"
 
+#include <cstddef>
 #include <boost/uuid/name_generator.hpp>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/string_generator.hpp>
@@ -47,4 +48,63 @@ namespace nmos
     {
         return details::to<id>(boost::uuids::name_generator(boost::uuids::string_generator()(namespace_id))(name));
     }
+
+    namespace details
+    {
+        // the value of a lowercase hexadecimal digit, or -1
+        static inline int hex_digit(utility::char_t c)
+        {
+            return c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        }
+
+        // parse the specified number of hexadecimal digits into the least significant bits of result
+        static inline bool parse_hex(const utility::char_t* first, std::size_t count, std::uint64_t& result)
+        {
+            for (auto last = first + count; last != first; ++first)
+            {
+                const auto digit = hex_digit(*first);
+                if (0 > digit) return false;
+                result = result << 4 | static_cast<std::uint64_t>(digit);
+            }
+            return true;
+        }
+
+        // format the least significant bits of value as the specified number of hexadecimal digits, ending at last
+        static inline void make_hex(std::uint64_t value, utility::char_t* last, std::size_t count)
+        {
+            static const char digits[] = "0123456789abcdef";
+            for (auto first = last - count; last != first; value >>= 4)
+            {
+                *--last = digits[value & 0xf];
+            }
+        }
+    }
+
+    // parse the canonical string form of a UUID, i.e. 32 lowercase hexadecimal digits in groups of 8-4-4-4-12 separated by hyphens
+    // returns false (and leaves result unchanged) if the id is not in canonical form, in which case it can only be used as a string
+    bool parse_uuid(const id& id, uuid& result)
+    {
+        if (36 != id.size() || '-' != id[8] || '-' != id[13] || '-' != id[18] || '-' != id[23]) return false;
+
+        const auto s = id.data();
+        std::uint64_t hi = 0, lo = 0;
+        if (!details::parse_hex(s, 8, hi) || !details::parse_hex(s + 9, 4, hi) || !details::parse_hex(s + 14, 4, hi)) return false;
+        if (!details::parse_hex(s + 19, 4, lo) || !details::parse_hex(s + 24, 12, lo)) return false;
+
+        result = { hi, lo };
+        return true;
+    }
+
+    // make the canonical string form of a UUID
+    id make_id(const uuid& uuid)
+    {
+        id result(36, '-');
+        const auto s = &result[0];
+        details::make_hex(uuid.hi >> 32, s + 8, 8);
+        details::make_hex(uuid.hi >> 16, s + 13, 4);
+        details::make_hex(uuid.hi, s + 18, 4);
+        details::make_hex(uuid.lo >> 48, s + 23, 4);
+        details::make_hex(uuid.lo, s + 36, 12);
+        return result;
+    }
 }
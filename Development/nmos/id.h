@@ -1,6 +1,7 @@
 #ifndef NMOS_ID_H
 #define NMOS_ID_H
 
+#include <cstdint>
 #include <memory>
 #include "cpprest/details/basic_types.h"
 
@@ -33,6 +34,28 @@ namespace nmos
 
     // generate a name-based UUID (v5)
     id make_repeatable_id(id namespace_id, const utility::string_t& name);
+
+    // the binary value of a UUID, which can be stored and compared more cheaply than the string form
+    // the ordering of UUIDs is the same as the ordering of their canonical string forms
+    struct uuid
+    {
+        uuid() : hi(0), lo(0) {}
+        uuid(std::uint64_t hi, std::uint64_t lo) : hi(hi), lo(lo) {}
+
+        std::uint64_t hi;
+        std::uint64_t lo;
+
+        friend bool operator==(const uuid& lhs, const uuid& rhs) { return lhs.hi == rhs.hi && lhs.lo == rhs.lo; }
+        friend bool operator!=(const uuid& lhs, const uuid& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const uuid& lhs, const uuid& rhs) { return lhs.hi < rhs.hi || (lhs.hi == rhs.hi && lhs.lo < rhs.lo); }
+    };
+
+    // parse the canonical string form of a UUID, i.e. 32 lowercase hexadecimal digits in groups of 8-4-4-4-12 separated by hyphens
+    // returns false (and leaves result unchanged) if the id is not in canonical form, in which case it can only be used as a string
+    bool parse_uuid(const id& id, uuid& result);
+
+    // make the canonical string form of a UUID
+    id make_id(const uuid& uuid);
 }
 
 #endif
@@ -1,5 +1,7 @@
 #include "nmos/jwt_validator.h"
 
+#include <mutex>
+#include <unordered_map>
 #include <boost/algorithm/string.hpp>
 #include <jwt-cpp/traits/nlohmann-json/traits.h>
 #include "cpprest/basic_utils.h"
@@ -27,6 +29,7 @@ namespace nmos
                     {
                         // empty out all jwt verifiers
                         validators.clear();
+                        key_validators.clear();
 
                         // create jwt verifier for each public key
 
@@ -62,7 +65,19 @@ namespace nmos
                             try
                             {
                                 validator.allow_algorithm(jwt::algorithm::rs512(utility::us2s(pubkey.at(U("pem")).as_string())));
-                                validators.push_back(validator);
+
+                                // Key ID (kid), optional!
+                                // keys with a kid are selected by the token's JOSE header kid rather than by trial verification
+                                // see https://tools.ietf.org/html/rfc7517#section-4.5
+                                // and https://tools.ietf.org/html/rfc7515#section-4.1.4
+                                if (jwk.has_field(U("kid")) && jwk.at(U("kid")).is_string())
+                                {
+                                    key_validators.insert({ utility::us2s(jwk.at(U("kid")).as_string()), validator });
+                                }
+                                else
+                                {
+                                    validators.push_back(validator);
+                                }
                             }
                             catch (const jwt::error::rsa_exception&)
                             {
@@ -78,6 +93,9 @@ namespace nmos
                 {
                     using namespace jwt::traits;
 
+                    // has this token already been verified by these public keys, and not yet expired?
+                    if (find_verified_token(token)) return;
+
                     const auto decoded_token = jwt::decode<nlohmann_json>(utility::us2s(token));
 
                     // do token JSON validation
@@ -86,18 +104,36 @@ namespace nmos
 
                     std::vector<std::string> errors;
 
+                    // select the candidate public keys by the token kid, falling back to trial verification
+                    // only for keys without a kid, or for tokens without a kid
+                    std::vector<const jwt::verifier<jwt::default_clock, nlohmann_json>*> candidates;
+                    const auto key_validator = decoded_token.has_key_id() ? key_validators.find(decoded_token.get_key_id()) : key_validators.end();
+                    if (key_validators.end() != key_validator)
+                    {
+                        candidates.push_back(&key_validator->second);
+                    }
+                    else
+                    {
+                        for (const auto& validator : validators) candidates.push_back(&validator);
+                        if (!decoded_token.has_key_id())
+                        {
+                            for (const auto& validator : key_validators) candidates.push_back(&validator.second);
+                        }
+                    }
+
                     // is JWT validator set up
-                    if (0 == validators.size()) { errors.push_back("no JWT validator to perform access token validation"); }
+                    if (0 == candidates.size()) { errors.push_back(validators.size() + key_validators.size() ? "no JWT validator matching the access token key id" : "no JWT validator to perform access token validation"); }
 
                     // do basic token validation
-                    for (const auto& validator : validators)
+                    for (const auto& validator : candidates)
                     {
                         try
                         {
                             // verify the signature & some of the common claims, such as exp, iat, nbf etc
-                            validator.verify(decoded_token);
+                            validator->verify(decoded_token);
 
                             // basic token validation successfully
+                            insert_verified_token(token, decoded_token);
                             return;
                         }
                         catch (const jwt::error::signature_verification_exception& e)
@@ -416,6 +452,50 @@ namespace nmos
                 }
 
             private:
+                // verified tokens are cached until they expire, so that the signature and the token JSON are only validated once per token
+                // the cache belongs to this set of public keys, so is flushed whenever the issuer's JWKS is updated and a new jwt_validator is constructed
+                static const size_t max_verified_tokens = 1024;
+
+                bool find_verified_token(const utility::string_t& token) const
+                {
+                    std::lock_guard<std::mutex> lock(verified_tokens_mutex);
+
+                    const auto found = verified_tokens.find(token);
+                    if (verified_tokens.end() == found) return false;
+
+                    // an expired token is re-validated in full, in order to report the expiry error
+                    if (found->second <= jwt::default_clock{}.now())
+                    {
+                        verified_tokens.erase(found);
+                        return false;
+                    }
+                    return true;
+                }
+
+                void insert_verified_token(const utility::string_t& token, const jwt::decoded_jwt<jwt::traits::nlohmann_json>& decoded_token) const
+                {
+                    // a token without exp would never expire from the cache
+                    if (!decoded_token.has_expires_at()) return;
+
+                    const auto expires_at = decoded_token.get_expires_at();
+
+                    std::lock_guard<std::mutex> lock(verified_tokens_mutex);
+
+                    if (verified_tokens.size() >= max_verified_tokens)
+                    {
+                        // first drop the expired tokens, and if that isn't enough, start over
+                        const auto now = jwt::default_clock{}.now();
+                        for (auto it = verified_tokens.begin(); verified_tokens.end() != it;)
+                        {
+                            if (it->second <= now) it = verified_tokens.erase(it);
+                            else ++it;
+                        }
+                        if (verified_tokens.size() >= max_verified_tokens) verified_tokens.clear();
+                    }
+
+                    verified_tokens[token] = expires_at;
+                }
+
                 std::string format_errors(const std::vector<std::string>& errs) const
                 {
                     std::string separator;
@@ -444,8 +524,15 @@ namespace nmos
                 };
 
             private:
+                // verifiers for public keys without a kid
                 std::vector<jwt::verifier<jwt::default_clock, jwt::traits::nlohmann_json>> validators;
+                // verifiers for public keys with a kid, indexed by kid
+                std::unordered_map<std::string, jwt::verifier<jwt::default_clock, jwt::traits::nlohmann_json>> key_validators;
                 token_json_validator token_validation;
+
+                // map of verified token to its expiry (exp)
+                mutable std::unordered_map<utility::string_t, jwt::date> verified_tokens;
+                mutable std::mutex verified_tokens_mutex;
             };
         }
 
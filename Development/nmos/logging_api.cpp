@@ -2,6 +2,7 @@
 
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/any_range.hpp>
 #include "nmos/api_utils.h"
 #include "nmos/query_utils.h"
 #include "nmos/slog.h"
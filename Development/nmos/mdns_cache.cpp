@@ -0,0 +1,292 @@
+#include "nmos/mdns_cache.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include "pplx/pplx_utils.h" // for pplx::complete_after, pplx::do_while
+#include "mdns/service_discovery_impl.h"
+#include "nmos/slog.h"
+
+namespace nmos
+{
+    namespace experimental
+    {
+        namespace details
+        {
+            // service type, domain and interface id, as browsed
+            typedef std::tuple<std::string, std::string, std::uint32_t> browse_key;
+
+            // service name, type, domain and interface id, as browse results and as resolved
+            typedef std::tuple<std::string, std::string, std::string, std::uint32_t> instance_key;
+
+            static instance_key make_instance_key(const mdns::browse_result& instance)
+            {
+                return instance_key{ instance.name, instance.type, instance.domain, instance.interface_id };
+            }
+
+            static bool equal_resolve_results(const std::vector<mdns::resolve_result>& lhs, const std::vector<mdns::resolve_result>& rhs)
+            {
+                return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const mdns::resolve_result& lhs, const mdns::resolve_result& rhs)
+                {
+                    return lhs.host_name == rhs.host_name
+                        && lhs.port == rhs.port
+                        && lhs.txt_records == rhs.txt_records
+                        && lhs.interface_id == rhs.interface_id
+                        && lhs.ip_addresses == rhs.ip_addresses;
+                });
+            }
+
+            struct browsed_instances
+            {
+                std::vector<mdns::browse_result> instances;
+                // time_point{} until the first refresh is complete
+                std::chrono::steady_clock::time_point expires;
+            };
+
+            struct resolved_instance
+            {
+                mdns::browse_result instance;
+                std::vector<mdns::resolve_result> resolved;
+                std::chrono::steady_clock::time_point expires;
+                // the same instance may be found by more than one browse, e.g. for the default domain and for "local."
+                std::set<browse_key> browsed_by;
+            };
+
+            class service_discovery_cache_impl : public mdns::details::service_discovery_impl
+            {
+            public:
+                service_discovery_cache_impl(mdns::service_discovery&& discovery, const std::chrono::steady_clock::duration& refresh_interval, service_instance_change_handler changed, slog::base_gate& gate)
+                    : discovery(std::move(discovery))
+                    , refresh_interval(refresh_interval)
+                    , changed(std::move(changed))
+                    , gate(gate)
+                {
+                }
+
+                ~service_discovery_cache_impl() override
+                {
+                    cancellation_source.cancel();
+
+                    // no new refresh loops can be started once this object is being destroyed
+                    for (const auto& refresh : refreshing)
+                    {
+                        pplx::details::wait_nothrow(refresh);
+                    }
+                }
+
+                pplx::task<bool> browse(const mdns::browse_handler& handler, const std::string& type, const std::string& domain, std::uint32_t interface_id, const std::chrono::steady_clock::duration& timeout, const pplx::cancellation_token& token) override
+                {
+                    std::vector<mdns::browse_result> instances;
+                    bool cached = false;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+
+                        const browse_key key{ type, domain, interface_id };
+                        auto found = browsed.find(key);
+                        if (browsed.end() == found)
+                        {
+                            // start to keep this browse up-to-date in the background, but for now, pass it through
+                            browsed.insert({ key, {} });
+                            start_refresh(key);
+                        }
+                        else if (std::chrono::steady_clock::now() < found->second.expires)
+                        {
+                            instances = found->second.instances;
+                            cached = true;
+                        }
+                    }
+
+                    if (!cached) return discovery.browse(handler, type, domain, interface_id, timeout, token);
+
+                    return pplx::create_task([handler, instances]
+                    {
+                        // stop as soon as the handler has had enough, as the underlying implementation does
+                        for (const auto& instance : instances)
+                        {
+                            if (handler(instance)) return true;
+                        }
+                        return false;
+                    }, token);
+                }
+
+                pplx::task<bool> resolve(const mdns::resolve_handler& handler, const std::string& name, const std::string& type, const std::string& domain, std::uint32_t interface_id, const std::chrono::steady_clock::duration& timeout, const pplx::cancellation_token& token) override
+                {
+                    std::vector<mdns::resolve_result> resolved;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+
+                        auto found = instances.find(instance_key{ name, type, domain, interface_id });
+                        if (instances.end() != found && std::chrono::steady_clock::now() < found->second.expires)
+                        {
+                            resolved = found->second.resolved;
+                        }
+                    }
+
+                    if (resolved.empty()) return discovery.resolve(handler, name, type, domain, interface_id, timeout, token);
+
+                    return pplx::create_task([handler, resolved]
+                    {
+                        // stop as soon as the handler has had enough, as the underlying implementation does
+                        for (const auto& result : resolved)
+                        {
+                            if (handler(result)) return true;
+                        }
+                        return false;
+                    }, token);
+                }
+
+                pplx::task<bool> getaddrinfo(const mdns::address_handler& handler, const std::string& host_name, std::uint32_t interface_id, const std::chrono::steady_clock::duration& timeout, const pplx::cancellation_token& token) override
+                {
+                    return discovery.getaddrinfo(handler, host_name, interface_id, timeout, token);
+                }
+
+            private:
+                // called with the mutex locked
+                void start_refresh(const browse_key& key)
+                {
+                    const auto token = cancellation_source.get_token();
+                    refreshing.push_back(pplx::do_while([this, key, token]
+                    {
+                        return pplx::create_task([this, key, token]
+                        {
+                            try
+                            {
+                                refresh(key, token);
+                            }
+                            catch (const pplx::task_canceled&)
+                            {
+                                throw;
+                            }
+                            catch (const std::exception& e)
+                            {
+                                // keep going, the cached results will go stale if the errors persist
+                                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Service discovery cache refresh error: " << e.what();
+                            }
+                        }, token).then([this, token]
+                        {
+                            return pplx::complete_after(refresh_interval, token);
+                        }).then([]
+                        {
+                            return true;
+                        });
+                    }, token));
+                }
+
+                void refresh(const browse_key& key, const pplx::cancellation_token& token)
+                {
+                    // the browse handler returns "had enough" so each query only takes as long as the DNS-SD daemon's answers keep coming
+                    const auto timeout = (std::max)(refresh_interval, std::chrono::steady_clock::duration(std::chrono::seconds(1)));
+
+                    const auto& type = std::get<0>(key);
+                    const auto& domain = std::get<1>(key);
+                    const auto interface_id = std::get<2>(key);
+
+                    // each call to get throws if the refresh is cancelled
+                    std::map<instance_key, std::pair<mdns::browse_result, std::vector<mdns::resolve_result>>> refreshed;
+                    for (const auto& instance : discovery.browse(type, domain, interface_id, timeout, token).get())
+                    {
+                        const auto instance_id = make_instance_key(instance);
+                        if (refreshed.end() != refreshed.find(instance_id)) continue;
+
+                        auto resolved = discovery.resolve(instance.name, instance.type, instance.domain, instance.interface_id, timeout, token).get();
+                        refreshed.insert({ instance_id, { instance, std::move(resolved) } });
+                    }
+
+                    std::vector<std::tuple<service_instance_change, mdns::browse_result, std::vector<mdns::resolve_result>>> changes;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+
+                        const auto expires = std::chrono::steady_clock::now() + 2 * refresh_interval;
+                        auto& browsed_instances = browsed[key];
+
+                        // instances which have gone away
+                        for (const auto& previous : browsed_instances.instances)
+                        {
+                            const auto instance_id = make_instance_key(previous);
+                            if (refreshed.end() != refreshed.find(instance_id)) continue;
+
+                            auto found = instances.find(instance_id);
+                            if (instances.end() == found) continue;
+
+                            found->second.browsed_by.erase(key);
+                            if (!found->second.browsed_by.empty()) continue;
+
+                            changes.push_back(std::make_tuple(service_instance_removed, found->second.instance, found->second.resolved));
+                            instances.erase(found);
+                        }
+
+                        // instances which are new or may have changed
+                        browsed_instances.instances.clear();
+                        for (auto& instance : refreshed)
+                        {
+                            browsed_instances.instances.push_back(instance.second.first);
+
+                            auto found = instances.find(instance.first);
+                            if (instances.end() == found)
+                            {
+                                changes.push_back(std::make_tuple(service_instance_added, instance.second.first, instance.second.second));
+                                instances.insert({ instance.first, { instance.second.first, std::move(instance.second.second), expires, { key } } });
+                            }
+                            else
+                            {
+                                if (!equal_resolve_results(found->second.resolved, instance.second.second))
+                                {
+                                    changes.push_back(std::make_tuple(service_instance_updated, instance.second.first, instance.second.second));
+                                    found->second.resolved = std::move(instance.second.second);
+                                }
+                                found->second.expires = expires;
+                                found->second.browsed_by.insert(key);
+                            }
+                        }
+                        browsed_instances.expires = expires;
+                    }
+
+                    slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Refreshed discovered service instances for regtype: " << type << " domain: " << domain << " with " << refreshed.size() << " instances, " << changes.size() << " changes";
+
+                    if (changed)
+                    {
+                        for (const auto& change : changes)
+                        {
+                            changed(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+                        }
+                    }
+                }
+
+                mdns::service_discovery discovery;
+                const std::chrono::steady_clock::duration refresh_interval;
+                service_instance_change_handler changed;
+                slog::base_gate& gate;
+
+                std::mutex mutex;
+                std::map<browse_key, browsed_instances> browsed;
+                std::map<instance_key, resolved_instance> instances;
+
+                pplx::cancellation_token_source cancellation_source;
+                std::vector<pplx::task<void>> refreshing;
+            };
+        }
+
+        // make a DNS-SD implementation which keeps a live cache of the service instances of each service type and domain that has been browsed
+        mdns::service_discovery make_service_discovery_cache(mdns::service_discovery&& discovery, const std::chrono::steady_clock::duration& refresh_interval, service_instance_change_handler changed, slog::base_gate& gate)
+        {
+            return mdns::service_discovery(std::unique_ptr<mdns::details::service_discovery_impl>(new details::service_discovery_cache_impl(std::move(discovery), refresh_interval, std::move(changed), gate)));
+        }
+
+        // make the DNS-SD implementation based on the specified settings
+        mdns::service_discovery make_service_discovery(const nmos::settings& settings, slog::base_gate& gate)
+        {
+            const auto refresh_interval = nmos::fields::discovery_cache_interval(settings);
+            if (0 == refresh_interval) return mdns::service_discovery(gate);
+
+            return make_service_discovery_cache(mdns::service_discovery(gate), std::chrono::seconds(refresh_interval), [&gate](service_instance_change change, const mdns::browse_result& instance, const std::vector<mdns::resolve_result>& resolved)
+            {
+                const auto port = !resolved.empty() ? resolved.front().port : 0;
+                slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Discovered service instance "
+                    << (service_instance_added == change ? "added" : service_instance_updated == change ? "updated" : "removed")
+                    << ": " << instance.name << " regtype: " << instance.type << " domain: " << instance.domain << " port: " << port;
+            }, gate);
+        }
+    }
+}
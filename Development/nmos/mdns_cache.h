@@ -0,0 +1,44 @@
+#ifndef NMOS_MDNS_CACHE_H
+#define NMOS_MDNS_CACHE_H
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "mdns/service_discovery.h"
+#include "nmos/settings.h" // just a forward declaration of nmos::settings required for nmos::experimental functions
+
+namespace slog
+{
+    class base_gate;
+}
+
+namespace nmos
+{
+    namespace experimental
+    {
+        // kinds of change to a discovered service instance
+        enum service_instance_change
+        {
+            service_instance_added,
+            service_instance_updated, // e.g. the TXT records, port or addresses have changed
+            service_instance_removed
+        };
+
+        // callback on a change to the discovered service instances, with the last resolved host name, port, TXT records and addresses
+        // the callback must not throw
+        typedef std::function<void(service_instance_change change, const mdns::browse_result& instance, const std::vector<mdns::resolve_result>& resolved)> service_instance_change_handler;
+
+        // make a DNS-SD implementation which keeps a live cache of the service instances of each service type and domain that has been browsed,
+        // by browsing and resolving them continuously in the background using the specified implementation, so that subsequent browse and resolve
+        // requests are answered immediately from memory, rather than each waiting for a fresh DNS-SD query to time out
+        // cached results which have not been refreshed within two refresh intervals are considered stale and requests are passed through
+        // to the specified implementation, as they are for any service type, domain or instance not (yet) in the cache
+        mdns::service_discovery make_service_discovery_cache(mdns::service_discovery&& discovery, const std::chrono::steady_clock::duration& refresh_interval, service_instance_change_handler changed, slog::base_gate& gate);
+
+        // make the DNS-SD implementation based on the specified settings, i.e. the default implementation, or if the discovery_cache_interval
+        // setting is non-zero, cached, with changes to the discovered service instances being logged
+        mdns::service_discovery make_service_discovery(const nmos::settings& settings, slog::base_gate& gate);
+    }
+}
+
+#endif
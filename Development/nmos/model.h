@@ -1,6 +1,11 @@
 #ifndef NMOS_MODEL_H
 #define NMOS_MODEL_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "nmos/mutex.h"
 #include "nmos/resources.h"
 #include "nmos/settings.h"
@@ -9,6 +14,70 @@
 // NMOS Node and Registry models
 namespace nmos
 {
+    // counts of the wakeups of threads waiting on a condition, in order to measure how many are spurious,
+    // i.e. when the thread found that what it was waiting for had not happened
+    struct wakeup_counters
+    {
+        // the number of buckets in the histogram of spurious wakeups per wait
+        static const std::size_t histogram_size = 8;
+
+        wakeup_counters() : wakeups(0), spurious_wakeups(0)
+        {
+            for (auto& bucket : spurious_wakeups_per_wait) bucket = 0;
+        }
+
+        std::atomic<std::uint64_t> wakeups;
+        std::atomic<std::uint64_t> spurious_wakeups;
+
+        // histogram of the number of spurious wakeups in each completed wait, i.e. bucket n counts the waits
+        // with exactly n spurious wakeups, except the last bucket, which counts the waits with that many or more
+        std::atomic<std::uint64_t> spurious_wakeups_per_wait[histogram_size];
+    };
+
+    // a channel to be used to wait for, and notify other threads about, changes to one member of the model, e.g. one set of resources
+    // so that threads which only watch that member aren't woken by every change to the model, nor other threads by changes to that member
+    // see base_model::notify
+    struct change_channel
+    {
+        change_channel() : epoch(0) {}
+
+        mutable nmos::condition_variable condition;
+
+        // incremented by each notification
+        mutable std::atomic<std::uint64_t> epoch;
+
+        mutable wakeup_counters wakeups;
+    };
+
+    namespace details
+    {
+        // wait until the predicate is satisfied, counting the wakeups (excluding the initial evaluation of the predicate
+        // and a final evaluation due to the timeout)
+        template <typename ConditionVariable, typename Lock, typename TimePoint, typename Predicate>
+        inline bool counted_wait_until(wakeup_counters& counters, ConditionVariable& condition, Lock& lock, const TimePoint& tp, Predicate predicate)
+        {
+            bool waiting = false;
+            std::size_t spurious = 0;
+            const bool satisfied = wait_until(condition, lock, tp, [&]
+            {
+                const bool result = predicate();
+                if (waiting)
+                {
+                    ++counters.wakeups;
+                    if (!result && ((TimePoint::max)() == tp || TimePoint::clock::now() < tp))
+                    {
+                        ++counters.spurious_wakeups;
+                        ++spurious;
+                    }
+                }
+                waiting = true;
+                return result;
+            });
+            ++counters.spurious_wakeups_per_wait[(std::min)(spurious, wakeup_counters::histogram_size - 1)];
+            return satisfied;
+        }
+    }
+
     struct base_model
     {
         // mutex to be used to protect the members of the model from simultaneous access by multiple threads
@@ -22,6 +91,9 @@ namespace nmos
         // by setting the shutdown flag
         mutable nmos::condition_variable shutdown_condition;
 
+        // the wakeups of threads waiting on the condition using the convenience functions below
+        mutable wakeup_counters wakeups;
+
         // application-wide configuration
         nmos::settings settings = web::json::value::object();
 
@@ -33,7 +105,20 @@ namespace nmos
 
         nmos::read_lock read_lock() const { return nmos::read_lock{ mutex }; }
         nmos::write_lock write_lock() const { return nmos::write_lock{ mutex }; }
-        void notify() const { return condition.notify_all(); }
+
+        // notify all threads waiting for changes to any member of the model, including those waiting on any change channel
+        void notify() const
+        {
+            condition.notify_all();
+            for (auto channel : channels) notify(*channel);
+        }
+
+        // notify only the threads waiting for changes to the member of the model associated with the specified change channel
+        void notify(const change_channel& channel) const
+        {
+            ++channel.epoch;
+            channel.condition.notify_all();
+        }
 
         template <class ReadOrWriteLock>
         void wait(ReadOrWriteLock& lock)
@@ -44,7 +129,13 @@ namespace nmos
         template <class ReadOrWriteLock, class Predicate>
         void wait(ReadOrWriteLock& lock, Predicate pred)
         {
-            condition.wait(lock, pred);
+            details::counted_wait_until(wakeups, condition, lock, (tai_clock::time_point::max)(), pred);
+        }
+
+        template <class ReadOrWriteLock, class Predicate>
+        void wait(const change_channel& channel, ReadOrWriteLock& lock, Predicate pred)
+        {
+            details::counted_wait_until(channel.wakeups, channel.condition, lock, (tai_clock::time_point::max)(), pred);
         }
 
         template <class ReadOrWriteLock, class TimePoint>
@@ -56,7 +147,13 @@ namespace nmos
         template <class ReadOrWriteLock, class TimePoint, class Predicate>
         bool wait_until(ReadOrWriteLock& lock, const TimePoint& abs_time, Predicate pred)
         {
-            return details::wait_until(condition, lock, abs_time, pred);
+            return details::counted_wait_until(wakeups, condition, lock, abs_time, pred);
+        }
+
+        template <class ReadOrWriteLock, class TimePoint, class Predicate>
+        bool wait_until(const change_channel& channel, ReadOrWriteLock& lock, const TimePoint& abs_time, Predicate pred)
+        {
+            return details::counted_wait_until(channel.wakeups, channel.condition, lock, abs_time, pred);
         }
 
         template <class ReadOrWriteLock, class Duration>
@@ -80,6 +177,10 @@ namespace nmos
             notify();
             shutdown_condition.notify_all();
         }
+
+    protected:
+        // the change channels of the derived model, which are also notified by notify()
+        std::vector<const change_channel*> channels;
     };
 
     struct model : base_model
@@ -90,6 +191,11 @@ namespace nmos
 
     struct node_model : model
     {
+        node_model()
+        {
+            channels = { &connection_changes, &events_changes, &channelmapping_changes, &control_protocol_changes };
+        }
+
         // IS-05 senders and receivers for this node
         // see nmos/connection_resources.h
         nmos::resources connection_resources;
@@ -105,6 +211,16 @@ namespace nmos
         // IS-12 resources for this node
         // see nmos/control_protocol_resources.h
         nmos::resources control_protocol_resources;
+
+        // change channels for the connection, events, channelmapping and control protocol resources, which may be notified
+        // instead of the model as a whole when only those resources have been changed, e.g. by their websocket API handlers,
+        // so that e.g. node behaviour isn't woken unnecessarily
+        // (there is no channel for the node resources, since changes to those are notified to the model as a whole, which
+        // already notifies every channel, and node behaviour also waits on the model's condition for its own background tasks)
+        change_channel connection_changes;
+        change_channel events_changes;
+        change_channel channelmapping_changes;
+        change_channel control_protocol_changes;
     };
 
     struct registry_model : model
@@ -1,5 +1,6 @@
 #include "nmos/node_api.h"
 
+#include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include "cpprest/json_validator.h"
 #include "nmos/api_downgrade.h"
@@ -7,6 +8,7 @@
 #include "nmos/is04_versions.h"
 #include "nmos/json_schema.h"
 #include "nmos/model.h"
+#include "nmos/query_utils.h" // for nmos::details::resource_representation_cache
 #include "nmos/scope.h"
 #include "nmos/slog.h"
 
@@ -111,7 +113,11 @@ namespace nmos
             return pplx::task_from_result(true);
         });
 
-        node_api.support(U("/") + nmos::patterns::subresourceType.pattern + U("/?"), methods::GET, [&model, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
+        // the serialized representations of unchanged resources are reused by subsequent requests
+        const auto representation_cache_max = with_read_lock(model.mutex, [&model] { return nmos::experimental::fields::representation_cache_max(model.settings); });
+        auto representations = std::make_shared<details::resource_representation_cache>((size_t)representation_cache_max);
+
+        node_api.support(U("/") + nmos::patterns::subresourceType.pattern + U("/?"), methods::GET, [&model, representations, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
         {
             nmos::api_gate gate(gate_, req, parameters);
             auto lock = model.read_lock();
@@ -122,17 +128,24 @@ namespace nmos
 
             const auto match = [&](const nmos::resources::value_type& resource) { return resource.type == nmos::type_from_resourceType(resourceType) && nmos::is_permitted_downgrade(resource, version); };
 
-            size_t count = 0;
+            // use the cached representations of unchanged resources
+            std::vector<utility::string_t> payload;
+            for (const auto& resource : resources | boost::adaptors::filtered(match))
+            {
+                const details::resource_representation_cache::key_type key{ resource.id, version, version, true };
+                payload.push_back({});
+                if (!representations->find(key, resource.updated, payload.back()))
+                {
+                    payload.back() = nmos::downgrade(resource, version).serialize();
+                    representations->insert(key, resource.updated, payload.back());
+                }
+            }
 
             set_reply(res, status_codes::OK,
-                web::json::serialize_array(resources
-                    | boost::adaptors::filtered(match)
-                    | boost::adaptors::transformed(
-                        [&count, &version](const nmos::resources::value_type& resource) { ++count; return nmos::downgrade(resource, version); }
-                    )),
+                U("[") + boost::algorithm::join(payload, U(",")) + U("]"),
                 web::http::details::mime_types::application_json);
 
-            slog::log<slog::severities::info>(gate, SLOG_FLF) << "Returning " << count << " matching " << resourceType;
+            slog::log<slog::severities::info>(gate, SLOG_FLF) << "Returning " << payload.size() << " matching " << resourceType;
 
             return pplx::task_from_result(true);
         });
@@ -1,5 +1,7 @@
 #include "nmos/node_behaviour.h"
 
+#include <algorithm>
+#include <set>
 #include "pplx/pplx_utils.h" // for pplx::complete_at
 #include "cpprest/http_client.h"
 #include "cpprest/json_storage.h"
@@ -10,6 +12,7 @@
 #include "nmos/authorization_state.h"
 #include "nmos/client_utils.h"
 #include "nmos/mdns.h"
+#include "nmos/mdns_cache.h"
 #include "nmos/model.h"
 #include "nmos/query_utils.h"
 #include "nmos/random.h"
@@ -50,7 +53,7 @@ namespace nmos
         mdns::service_advertiser advertiser(gate);
         mdns::service_advertiser_guard advertiser_guard(advertiser);
 
-        mdns::service_discovery discovery(gate);
+        mdns::service_discovery discovery(nmos::experimental::make_service_discovery(with_read_lock(model.mutex, [&] { return model.settings; }), gate));
 
         details::node_behaviour_thread(model, std::move(load_ca_certificates), std::move(registration_changed), std::move(get_authorization_bearer_token), advertiser, discovery, gate);
     }
@@ -61,7 +64,7 @@ namespace nmos
         mdns::service_advertiser advertiser(gate);
         mdns::service_advertiser_guard advertiser_guard(advertiser);
 
-        mdns::service_discovery discovery(gate);
+        mdns::service_discovery discovery(nmos::experimental::make_service_discovery(with_read_lock(model.mutex, [&] { return model.settings; }), gate));
 
         details::node_behaviour_thread(model, std::move(load_ca_certificates), std::move(registration_changed), {}, advertiser, discovery, gate);
     }
@@ -374,12 +377,11 @@ namespace nmos
                 , grain(grain)
                 , events(events)
             {
-                // steal the events from the grain
+                // steal the events from the grain (and those recorded for it)
                 // reset the grain for next time
+                events = take_resource_events(resources, grain);
                 resources.modify(grain, [&](nmos::resource& grain)
                 {
-                    using std::swap;
-                    swap(events, nmos::fields::message_grain_data(grain.data));
                     grain.updated = strictly_increasing_update(resources);
                 });
             }
@@ -639,6 +641,132 @@ namespace nmos
             return pplx::task_from_result();
         }
 
+        // experimental extension, to determine whether the Registration API advertises the batch registration endpoint
+        pplx::task<bool> request_registration_batch_support(web::http::client::http_client client, slog::base_gate& gate, const pplx::cancellation_token& token = pplx::cancellation_token::none())
+        {
+            return api_request(client, web::http::methods::GET, gate, token).then([&gate](web::http::http_response response)
+            {
+                if (web::http::status_codes::OK != response.status_code()) return pplx::task_from_result(web::json::value::array());
+                return nmos::details::extract_json(response, gate);
+            }).then([&gate](pplx::task<web::json::value> body_task)
+            {
+                try
+                {
+                    const auto body = body_task.get();
+                    if (!body.is_array()) return false;
+                    const auto& sub_routes = body.as_array();
+                    return sub_routes.end() != std::find(sub_routes.begin(), sub_routes.end(), web::json::value::string(U("x-batch/")));
+                }
+                catch (const std::exception& e)
+                {
+                    slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration API listing error: " << e.what();
+                    return false;
+                }
+            });
+        }
+
+        // experimental extension, to make an asynchronous POST request on the batch registration endpoint of the Registration API specified by the client
+        // for the specified 'added', 'modified' or 'sync' resource events, which must be in referential order
+        // if the registration for any of the resource events fails, e.g. because the registration is out of sync, the usual individual requests
+        // are made for that and all subsequent resource events
+        pplx::task<void> request_registrations(web::http::client::http_client client, const std::vector<web::json::value>& events, slog::base_gate& gate, const pplx::cancellation_token& token = pplx::cancellation_token::none())
+        {
+            slog::log<slog::severities::info>(gate, SLOG_FLF) << "Requesting batch registration for " << events.size() << " resources";
+
+            auto body = web::json::value::array();
+            for (const auto& event : events)
+            {
+                const auto id_type = get_resource_event_resource(node_behaviour_topic, event);
+                web::json::push_back(body, make_registration_request_body(id_type.second, event.at(U("post"))));
+            }
+
+            return api_request(client, web::http::methods::POST, U("/x-batch/resource"), body, gate, token).then([=, &gate](web::http::http_response response)
+            {
+                if (web::http::status_codes::OK == response.status_code())
+                {
+                    return nmos::details::extract_json(response, gate);
+                }
+
+                // server (5xx) errors will throw, any other error means falling back to individual requests for all the resource events
+                handle_registration_error_conditions(response, gate, "batch registration");
+                return pplx::task_from_result(web::json::value::array());
+            }).then([=, &gate](web::json::value results)
+            {
+                size_t count = 0;
+                for (; count < events.size(); ++count)
+                {
+                    const auto& event = events[count];
+                    const auto id_type = get_resource_event_resource(node_behaviour_topic, event);
+                    const auto creation = resource_added_event == get_resource_event_type(event);
+
+                    const auto code = results.is_array() && count < results.size() ? web::json::field_as_integer_or{ U("code"), 0 }(results.at(count)) : 0;
+                    if (web::http::status_codes::Created == code && creation)
+                    {
+                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration created for " << id_type;
+                    }
+                    else if (web::http::status_codes::OK == code && !creation)
+                    {
+                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration updated for " << id_type;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+
+                // sequentially make individual requests for any remaining resource events
+                pplx::task<void> remaining = pplx::task_from_result();
+                for (; count < events.size(); ++count)
+                {
+                    const auto event = events[count];
+                    remaining = remaining.then([=, &gate]
+                    {
+                        return request_registration(client, event, gate, token);
+                    });
+                }
+                return remaining;
+            });
+        }
+
+        // determine how many of the leading resource events may be registered in one request to the experimental batch registration endpoint
+        // i.e. 'added', 'modified' or 'sync' resource events, since deletions can only be requested individually, and at most one for each
+        // resource, since the registry uses the same received time for all the requests in a batch
+        size_t count_batch_registrations(const web::json::value& events, size_t max)
+        {
+            std::set<nmos::id> ids;
+            size_t count = 0;
+            for (; count < events.size() && count < max; ++count)
+            {
+                const auto& event = events.at(count);
+                if (resource_removed_event == get_resource_event_type(event)) break;
+
+                if (!ids.insert(get_resource_event_resource(node_behaviour_topic, event).first).second) break;
+            }
+            return count;
+        }
+
+        // determine how many of the leading resource events may be requested concurrently, i.e. none is for the same resource or a sub-resource
+        // of another, so that the referential order is maintained; deletions are always requested individually so that all sub-resources have
+        // been deleted first, and in particular, in order that the Node resource itself is deleted last
+        size_t count_independent_registrations(const web::json::value& events, const nmos::api_version& version, size_t max)
+        {
+            std::set<nmos::id> ids;
+            size_t count = 0;
+            for (; count < events.size() && count < max; ++count)
+            {
+                const auto& event = events.at(count);
+                if (resource_removed_event == get_resource_event_type(event)) break;
+
+                const auto id_type = get_resource_event_resource(node_behaviour_topic, event);
+                const auto super_id_type = nmos::get_super_resource(version, id_type.second, event.at(U("post")));
+                if (0 != ids.count(id_type.first) || 0 != ids.count(super_id_type.first)) break;
+
+                ids.insert(id_type.first);
+            }
+            // always make progress!
+            return (std::max)(count, size_t(1));
+        }
+
         // asynchronously perform a heartbeat and return a result that indicates whether the heartbeat was successful
         pplx::task<bool> update_node_health(web::http::client::http_client client, const nmos::id& id, slog::base_gate& gate, const pplx::cancellation_token& token = pplx::cancellation_token::none())
         {
@@ -708,7 +836,7 @@ namespace nmos
                 // or because the node was registered successfully
                 // or because an error has been encountered with the selected registration service
                 // or because the server is being shut down
-                condition.wait(lock, [&]{ return shutdown || registration_service_error || node_registered || most_recent_update < grain->updated; });
+                condition.wait(lock, [&]{ return shutdown || registration_service_error || node_registered || most_recent_update < grain->updated || 0 != count_resource_events(resources, *grain); });
                 if (registration_service_error)
                 {
                     pop_registration_service(model.settings);
@@ -746,6 +874,7 @@ namespace nmos
 
                         subscription.updated = strictly_increasing_update(resources);
                     });
+                    nmos::details::update_subscription_query(resources, *subscription);
 
                     // reset the node behaviour subscription grain; if the node resource has already been added to the model then
                     // the first event will be a 'sync' event for the node (and if not, there really should be no events at all!)
@@ -760,6 +889,7 @@ namespace nmos
 
                         grain.updated = strictly_increasing_update(resources);
                     });
+                    discard_resource_events(resources, *grain);
 
                     const auto bearer_token = get_authorization_bearer_token ? get_authorization_bearer_token() : web::http::oauth2::experimental::oauth2_token{};
                     registration_client = nmos::details::make_http_client(base_uri, make_registration_client_config(model.settings, load_ca_certificates, bearer_token, gate));
@@ -852,7 +982,12 @@ namespace nmos
             bool node_registered(false);
             bool node_unregistered(false);
 
+            // experimental extension, whether the Registration API advertises the batch registration endpoint
+            bool registration_batch(false);
+
             web::json::value events;
+            // the indices of the resource events which have been successfully requested, when requests are made concurrently
+            std::set<size_t> completed;
 
             std::chrono::steady_clock::time_point heartbeat_time;
 
@@ -863,6 +998,7 @@ namespace nmos
             pplx::cancellation_token_source cancellation_source;
             pplx::task<void> request = pplx::task_from_result();
             pplx::task<void> heartbeats = pplx::task_from_result();
+            pplx::task<void> batch_support = pplx::task_from_result();
 
             // "7. The Node registers its other resources (from /devices, /sources etc) with the Registration API."
 
@@ -874,7 +1010,7 @@ namespace nmos
                 // or because the node was unregistered (cleanly, or as a result of missed heartbeats)
                 // or because an error has been encountered with the selected registration service
                 // or because the server is being shut down
-                condition.wait(lock, [&]{ return shutdown || registration_service_error || node_unregistered || most_recent_update < grain->updated; });
+                condition.wait(lock, [&]{ return shutdown || registration_service_error || node_unregistered || most_recent_update < grain->updated || 0 != count_resource_events(resources, *grain); });
                 if (registration_service_error)
                 {
                     pop_registration_service(model.settings);
@@ -886,6 +1022,7 @@ namespace nmos
                     details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
                     request.wait();
                     heartbeats.wait();
+                    batch_support.wait();
 
                     registration_client.reset();
                     heartbeat_client.reset();
@@ -988,6 +1125,20 @@ namespace nmos
                         model.notify();
                     });
 
+                    // experimental extension, meanwhile determine whether resources can be registered in batches
+                    // (until the response has been received, individual requests are made)
+                    registration_batch = false;
+                    if (1 < nmos::experimental::fields::registration_batch_max(model.settings))
+                    {
+                        batch_support = request_registration_batch_support(*registration_client, gate, token).then([&](bool supported)
+                        {
+                            auto lock = model.write_lock(); // in order to update local state
+
+                            if (supported) slog::log<slog::severities::info>(gate, SLOG_FLF) << "Registration API supports batch registration";
+                            registration_batch = supported;
+                        });
+                    }
+
                     // wait for the response from the first heartbeat that the Node is still registered (or not!)
                     condition.wait(lock, [&]{ return shutdown || registration_service_error || node_unregistered || node_registered; });
                     if (shutdown || registration_service_error || node_unregistered) continue;
@@ -1001,9 +1152,6 @@ namespace nmos
                 {
                     if (shutdown || registration_service_error || node_unregistered) break;
 
-                    const auto id_type = get_resource_event_resource(node_behaviour_topic, events.at(0));
-                    const auto event_type = get_resource_event_type(events.at(0));
-
                     auto token = cancellation_source.get_token();
 
                     // renew registration_client if bearer token has changed
@@ -1019,45 +1167,109 @@ namespace nmos
                         }
                     }
 
-                    request = details::request_registration(*registration_client, events.at(0), gate, token).then([&, id_type, event_type](pplx::task<void> finally)
+                    // experimental extension, register as many resources as possible in one request
+                    const auto batch_count = registration_batch ? count_batch_registrations(events, (size_t)nmos::experimental::fields::registration_batch_max(model.settings)) : 0;
+                    if (1 < batch_count)
                     {
-                        auto lock = model.write_lock(); // in order to update local state
+                        std::vector<web::json::value> batch_events;
+                        batch_events.reserve(batch_count);
+                        for (size_t i = 0; i < batch_count; ++i)
+                        {
+                            batch_events.push_back(events.at(i));
+                        }
 
-                        try
+                        request = details::request_registrations(*registration_client, batch_events, gate, token).then([&, batch_count](pplx::task<void> finally)
                         {
-                            finally.get();
+                            auto lock = model.write_lock(); // in order to update local state
 
-                            // on success (or an ignored failure), discard the resource event
-                            if (0 != events.size())
+                            try
                             {
-                                events.erase(0);
+                                finally.get();
+
+                                // on success (or ignored failures), discard the resource events
+                                auto& events_storage = web::json::storage_of(events.as_array());
+                                events_storage.erase(events_storage.begin(), events_storage.begin() + (std::min)(batch_count, events_storage.size()));
                             }
+                            catch (const web::http::http_exception& e)
+                            {
+                                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration request HTTP error: " << e.what() << " [" << e.error_code() << "]";
 
-                            // "Following deletion of all other resources, the Node resource may be deleted and heartbeating stopped."
-                            // See https://specs.amwa.tv/is-04/releases/v1.2.0/docs/4.1._Behaviour_-_Registration.html#controlled-unregistration
-                            if (self_id == id_type.first && resource_removed_event == event_type)
+                                registration_service_error = true;
+                            }
+                            catch (const registration_service_exception&)
                             {
-                                node_unregistered = true;
+                                registration_service_error = true;
                             }
-                        }
-                        catch (const web::http::http_exception& e)
+                        });
+                    }
+                    else
+                    {
+                        // otherwise, pipeline requests for resources which do not depend on each other, up to the configured window
+                        const auto count = count_independent_registrations(events, grain->version, (size_t)nmos::experimental::fields::registration_request_window(model.settings));
+
+                        completed.clear();
+                        std::vector<pplx::task<void>> requests;
+                        requests.reserve(count);
+                        for (size_t i = 0; i < count; ++i)
                         {
-                            slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration request HTTP error: " << e.what() << " [" << e.error_code() << "]";
+                            const auto id_type = get_resource_event_resource(node_behaviour_topic, events.at(i));
+                            const auto event_type = get_resource_event_type(events.at(i));
 
-                            registration_service_error = true;
+                            requests.push_back(details::request_registration(*registration_client, events.at(i), gate, token).then([&, i, id_type, event_type](pplx::task<void> finally)
+                            {
+                                auto lock = model.write_lock(); // in order to update local state
+
+                                try
+                                {
+                                    finally.get();
+
+                                    // on success (or an ignored failure), the resource event will be discarded
+                                    completed.insert(i);
+
+                                    // "Following deletion of all other resources, the Node resource may be deleted and heartbeating stopped."
+                                    // See https://specs.amwa.tv/is-04/releases/v1.2.0/docs/4.1._Behaviour_-_Registration.html#controlled-unregistration
+                                    if (self_id == id_type.first && resource_removed_event == event_type)
+                                    {
+                                        node_unregistered = true;
+                                    }
+                                }
+                                catch (const web::http::http_exception& e)
+                                {
+                                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration request HTTP error: " << e.what() << " [" << e.error_code() << "]";
+
+                                    registration_service_error = true;
+                                }
+                                catch (const registration_service_exception&)
+                                {
+                                    registration_service_error = true;
+                                }
+                            }));
                         }
-                        catch (const registration_service_exception&)
+
+                        request = pplx::when_all(requests.begin(), requests.end()).then([&](pplx::task<void> finally)
                         {
-                            registration_service_error = true;
-                        }
-                    });
+                            auto lock = model.write_lock(); // in order to update local state
+
+                            // discard the resource events which were successfully requested, in reverse order to keep the indices valid
+                            for (auto it = completed.rbegin(); completed.rend() != it; ++it)
+                            {
+                                if (*it < events.size())
+                                {
+                                    events.erase(*it);
+                                }
+                            }
+                            completed.clear();
+
+                            finally.get();
+                        });
+                    }
                     // avoid race condition between condition.notify_all() and request.is_done()
                     request.then([&]
                     {
                         condition.notify_all();
                     });
 
-                    // wait for the request because interactions with the Registration API /resource endpoint must be sequential
+                    // wait for the request(s) because interactions with the Registration API /resource endpoint must maintain the referential order
                     condition.wait(lock, [&]{ return shutdown || registration_service_error || node_unregistered || request.is_done(); });
                 }
             }
@@ -1076,6 +1288,7 @@ namespace nmos
             details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
             request.wait();
             heartbeats.wait();
+            batch_support.wait();
         }
     }
 
@@ -1162,7 +1375,7 @@ namespace nmos
                 // or because a Registration API has been discovered so registered operation should be attempted
                 // or because the server is being shut down
                 // or because message sending was throttled earlier
-                details::wait_until(condition, lock, earliest_necessary_update, [&] { return shutdown || registration_services_discovered || most_recent_update < grain->updated; });
+                details::wait_until(condition, lock, earliest_necessary_update, [&] { return shutdown || registration_services_discovered || most_recent_update < grain->updated || 0 != count_resource_events(resources, *grain); });
                 if (shutdown || registration_services_discovered) break;
 
                 // usually the daemon will be updated
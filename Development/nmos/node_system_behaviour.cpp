@@ -9,6 +9,7 @@
 #include "nmos/is09_versions.h"
 #include "nmos/json_schema.h"
 #include "nmos/mdns.h"
+#include "nmos/mdns_cache.h"
 #include "nmos/model.h"
 #include "nmos/random.h"
 #include "nmos/slog.h"
@@ -36,7 +37,7 @@ namespace nmos
     {
         nmos::details::omanip_gate gate(gate_, nmos::stash_category(nmos::categories::node_system_behaviour));
 
-        mdns::service_discovery discovery(gate);
+        mdns::service_discovery discovery(nmos::experimental::make_service_discovery(with_read_lock(model.mutex, [&] { return model.settings; }), gate));
 
         details::node_system_behaviour_thread(model, std::move(load_ca_certificates), std::move(system_changed), discovery, gate);
     }
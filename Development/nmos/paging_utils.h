@@ -1,6 +1,9 @@
 #ifndef NMOS_PAGING_UTILS_H
 #define NMOS_PAGING_UTILS_H
 
+#include <algorithm>
+#include <vector>
+#include <boost/iterator/indirect_iterator.hpp>
 #include <boost/range/algorithm/lower_bound.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/sub_range.hpp>
@@ -132,6 +135,83 @@ namespace nmos
 
             return page;
         }
+
+        // A page of values which have already been found to match the filter predicate
+        template <typename Value>
+        struct evaluated_page
+        {
+            typedef boost::indirect_iterator<typename std::vector<const Value*>::const_iterator> const_iterator;
+            typedef const_iterator iterator;
+
+            const_iterator begin() const { return values.begin(); }
+            const_iterator end() const { return values.end(); }
+            bool empty() const { return values.empty(); }
+            size_t size() const { return values.size(); }
+
+            std::vector<const Value*> values;
+        };
+
+        // Cursor-based paging with the same results as cursor_based_page, except that the filter predicate is evaluated just once for each value
+        // and only for as many values as are required to determine the page and the updated cursors, i.e. up to limit + 1 matching values
+        // (whereas the sub-range returned by cursor_based_page evaluates the predicate again when it is iterated)
+        template <typename Range, typename Predicate, typename Cursor>
+        evaluated_page<typename boost::range_value<Range>::type> evaluated_cursor_based_page(Range& range, Predicate match, Cursor& lower, Cursor& upper, typename boost::range_size<Range>::type limit = (std::numeric_limits<typename boost::range_size<Range>::type>::max)(), bool take_lower = true)
+        {
+            using details::extract_cursor; // customisation point
+
+            evaluated_page<typename boost::range_value<Range>::type> page;
+
+            if (0 == limit)
+            {
+                if (take_lower)
+                    upper = lower;
+                else
+                    lower = upper;
+
+                return page;
+            }
+
+            auto bounded = details::make_bounded_range(range, lower, upper);
+
+            if (take_lower)
+            {
+                for (auto it = bounded.begin(); bounded.end() != it; ++it)
+                {
+                    if (!match(*it)) continue;
+
+                    // another matching value after the page determines the upper cursor
+                    if (limit == page.values.size())
+                    {
+                        upper = extract_cursor(range, it);
+                        break;
+                    }
+
+                    page.values.push_back(&*it);
+                }
+            }
+            else
+            {
+                auto first = bounded.end();
+                for (auto it = bounded.end(); bounded.begin() != it;)
+                {
+                    --it;
+                    if (!match(*it)) continue;
+
+                    // another matching value before the page means the lower cursor is the first value in the page
+                    if (limit == page.values.size())
+                    {
+                        lower = extract_cursor(range, first);
+                        break;
+                    }
+
+                    page.values.push_back(&*it);
+                    first = it;
+                }
+                std::reverse(page.values.begin(), page.values.end());
+            }
+
+            return page;
+        }
     }
 }
 
@@ -1,5 +1,6 @@
 #include "nmos/query_api.h"
 
+#include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include "cpprest/json_validator.h"
 #include "cpprest/json_visit.h"
@@ -103,6 +104,10 @@ namespace nmos
             {
                 flat_query_params[nmos::experimental::fields::query_strip] = web::json::value::parse(nmos::experimental::fields::query_strip(flat_query_params));
             }
+            if (flat_query_params.has_field(nmos::experimental::fields::query_patch))
+            {
+                flat_query_params[nmos::experimental::fields::query_patch] = web::json::value::parse(nmos::experimental::fields::query_patch(flat_query_params));
+            }
 
             return flat_query_params;
         }
@@ -333,7 +338,11 @@ namespace nmos
             return pplx::task_from_result(true);
         });
 
-        query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/?"), methods::GET, [&model, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
+        // the serialized representations of unchanged resources are reused by subsequent requests
+        const auto representation_cache_max = with_read_lock(model.mutex, [&model] { return nmos::experimental::fields::representation_cache_max(model.settings); });
+        auto representations = std::make_shared<details::resource_representation_cache>((size_t)representation_cache_max);
+
+        query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/?"), methods::GET, [&model, representations, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
         {
             nmos::api_gate gate(gate_, req, parameters);
             auto lock = model.read_lock();
@@ -362,33 +371,69 @@ namespace nmos
             if (paging.valid())
             {
                 // Get the payload and update the paging parameters
-                auto page = paging.page(resources, pred);
+                // since the query is scoped to a single resource type, only the resources of that type need to be considered
+                auto page = paging.page(resources, nmos::type_from_resourceType(resourceType), pred);
+
+                const auto base_link = details::make_query_uri_with_no_paging(req, model.settings);
 
                 size_t count = 0;
 
                 // experimental extension, to support human-readable HTML rendering of NMOS responses
                 if (experimental::details::is_html_response_preferred(req, web::http::details::mime_types::application_json))
                 {
+                    // take a snapshot of the (downgraded) resources in the page, which is bounded by the paging limit
+                    // so that they can be rendered without holding the lock on the model
+                    std::vector<web::json::value> payload;
+                    for (const auto& resource : page)
+                    {
+                        payload.push_back(match.downgrade(resource));
+                    }
+                    count = payload.size();
+
+                    lock.unlock();
+
                     set_reply(res, status_codes::OK,
-                        web::json::serialize_array(page
+                        web::json::serialize_array(payload
                             | boost::adaptors::transformed(
-                                [&count, &match, &version, &resourceType](const nmos::resource& resource) { ++count; return experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), match.downgrade(resource)); }
+                                [&version, &resourceType](const web::json::value& data) { return experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), data); }
                             )),
                         web::http::details::mime_types::application_json);
                 }
                 else
                 {
+                    // use the cached representations of unchanged resources in the page, which is bounded by the paging limit,
+                    // and take a snapshot of the (downgraded) other resources, so that they can be serialized without holding the lock
+                    // on the model, since that is the expensive part
+                    std::vector<utility::string_t> payload;
+                    std::vector<std::tuple<size_t, details::resource_representation_cache::key_type, nmos::tai, web::json::value>> pending;
+                    for (const auto& resource : page)
+                    {
+                        auto key = details::resource_representation_cache::make_key(resource, match);
+                        payload.push_back({});
+                        if (!representations->find(key, resource.updated, payload.back()))
+                        {
+                            pending.push_back(std::make_tuple(payload.size() - 1, std::move(key), resource.updated, match.downgrade(resource)));
+                        }
+                    }
+                    count = payload.size();
+
+                    lock.unlock();
+
+                    for (const auto& p : pending)
+                    {
+                        auto& representation = payload[std::get<0>(p)];
+                        representation = std::get<3>(p).serialize();
+                        representations->insert(std::get<1>(p), std::get<2>(p), representation);
+                    }
+
                     set_reply(res, status_codes::OK,
-                        web::json::serialize_array(page
-                            | boost::adaptors::transformed(
-                                [&count, &match](const nmos::resources::value_type& resource) { ++count; return match.downgrade(resource); }
-                            )),
+                        U("[") + boost::algorithm::join(payload, U(",")) + U("]"),
                         web::http::details::mime_types::application_json);
                 }
 
                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Returning " << count << " matching " << resourceType;
 
-                details::add_paging_headers(res.headers(), paging, details::make_query_uri_with_no_paging(req, model.settings));
+                details::add_paging_headers(res.headers(), paging, base_link);
             }
             else
             {
@@ -398,7 +443,7 @@ namespace nmos
             return pplx::task_from_result(true);
         });
 
-        query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/") + nmos::patterns::resourceId.pattern + U("/?"), methods::GET, [&model, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
+        query_api.support(U("/") + nmos::patterns::queryType.pattern + U("/") + nmos::patterns::resourceId.pattern + U("/?"), methods::GET, [&model, representations, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
         {
             nmos::api_gate gate(gate_, req, parameters);
             auto lock = model.read_lock();
@@ -422,20 +467,44 @@ namespace nmos
                 {
                     slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Returning resource: " << resourceId;
 
+                    // experimental extension, see also nmos::make_resource_events for equivalent WebSockets extension
+                    if (!match.strip || resource->version < match.version)
+                    {
+                        res.headers().add(U("X-API-Version"), make_api_version(resource->version));
+                    }
+
                     // experimental extension, to support human-readable HTML rendering of NMOS responses
                     if (experimental::details::is_html_response_preferred(req, web::http::details::mime_types::application_json))
                     {
-                        set_reply(res, status_codes::OK, experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), match.downgrade(*resource)));
+                        // take a snapshot of the (downgraded) resource so that it can be rendered without holding the lock on the model
+                        const auto data = match.downgrade(*resource);
+
+                        lock.unlock();
+
+                        set_reply(res, status_codes::OK, experimental::details::make_query_api_html_response_body(version, nmos::type_from_resourceType(resourceType), data));
                     }
                     else
                     {
-                        set_reply(res, status_codes::OK, match.downgrade(*resource));
-                    }
+                        // use the cached representation if the resource is unchanged
+                        // otherwise take a snapshot of the (downgraded) resource so that it can be serialized without holding the lock on the model
+                        const auto key = details::resource_representation_cache::make_key(*resource, match);
+                        const auto updated = resource->updated;
+                        utility::string_t representation;
+                        if (representations->find(key, updated, representation))
+                        {
+                            lock.unlock();
+                        }
+                        else
+                        {
+                            const auto data = match.downgrade(*resource);
 
-                    // experimental extension, see also nmos::make_resource_events for equivalent WebSockets extension
-                    if (!match.strip || resource->version < match.version)
-                    {
-                        res.headers().add(U("X-API-Version"), make_api_version(resource->version));
+                            lock.unlock();
+
+                            representation = data.serialize();
+                            representations->insert(key, updated, representation);
+                        }
+
+                        set_reply(res, status_codes::OK, representation, web::http::details::mime_types::application_json);
                     }
                 }
                 else
@@ -1,5 +1,6 @@
 #include "nmos/query_utils.h"
 
+#include <algorithm>
 #include <set>
 #include <boost/algorithm/string/erase.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -7,6 +8,7 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include "cpprest/basic_utils.h"
+#include "cpprest/json_utils.h" // for web::json::diff
 #include "nmos/api_downgrade.h"
 #include "nmos/api_utils.h" // for nmos::resourceType_from_type
 #include "nmos/rational.h"
@@ -30,6 +32,8 @@ namespace nmos
         }
     }
 
+    web::json::value equal_to(const web::json::value& lhs, const web::json::value& rhs);
+    web::json::value less(const web::json::value& lhs, const web::json::value& rhs);
     rql::operators make_rql_operators(const nmos::resources& resources);
 
     resource_query::resource_query(const nmos::api_version& version, const utility::string_t& resource_path, const web::json::value& flat_query_params)
@@ -38,6 +42,7 @@ namespace nmos
         , basic_query(web::json::unflatten(flat_query_params))
         , downgrade_version(version)
         , strip(true)
+        , patch(false)
         , match_flags(web::json::match_default)
     {
         // extract the supported advanced query options
@@ -59,6 +64,7 @@ namespace nmos
                     rql_query = rql::parse_query(field.second.as_string());
                     // validate against call-operators used in nmos::match_rql
                     rql::validate_query(rql_query, make_rql_operators({}));
+                    rql_plan = rql::compile_query(rql_query, equal_to, less, { U("rel"), U("sub") });
                 }
                 // extract the experimental flag, used to override the default behaviour that resources
                 // "must have all [higher-versioned] keys stripped by the Query API before they are returned"
@@ -67,6 +73,12 @@ namespace nmos
                 {
                     strip = field.second.as_bool();
                 }
+                // extract the experimental flag, used to request that modified resource events on the websocket connections of a subscription
+                // are made compact by sending a JSON Patch in place of the "pre" and "post" values
+                else if (field.first == U("patch"))
+                {
+                    patch = field.second.as_bool();
+                }
                 // extract the experimental match flags, which extend Basic Queries with really simple per-query control of string matching
                 else if (field.first == U("match_type"))
                 {
@@ -305,30 +317,48 @@ namespace nmos
             return indeterminate ? rql::value_indeterminate : rql::value_false;
         }
 
+        // find the linked data for the 'rel' operator
+        // if the linked resource is not found, this is rql::value_indeterminate, against which evaluating the sub-query throws
+        static const web::json::value* find_rel(const nmos::resources& resources, const utility::string_t& relation_name, const web::json::value& relation_value)
+        {
+            static const auto empty = web::json::value::object();
+
+            if (relation_value.is_string())
+            {
+                // initially support relation-names that are the '<type>_id' properties, such as a sender's flow_id
+                // and the 'subscription.sender_id' property of receivers (and vice-versa of senders)
+                // other candidates are more complicated for various reasons...
+                // for the 'parents' properties of sources and flows, the resource type is also needed
+                // for 'interface_bindings' and 'clock_name', device_id and node_id are also needed to identify the node resource
+                // some 'href' properties like the 'manifest_href' of a sender could be interesting
+                nmos::type relation_type{ erase_tail_copy(relation_name.substr(relation_name.find_last_of(U('.')) + 1), U("_id")) };
+                nmos::id relation_id{ relation_value.as_string() };
+
+                auto found = find_resource(resources, { relation_id, relation_type });
+                if (resources.end() == found) return &rql::value_indeterminate;
+
+                // return the linked value
+                return &found->data;
+            }
+            return &empty;
+        }
+
+        // find the sub-object for the 'sub' operator
+        static const web::json::value* find_sub(const web::json::value& relation_value)
+        {
+            static const auto empty = web::json::value::object();
+
+            // effectively just changes the extractor context to a sub-object
+            return relation_value.is_object() ? &relation_value : &empty;
+        }
+
         // Experimental support for the 'rel' operator, in order to allow e.g. matching senders based on their flows' formats
         // rel(<relation-name>, <call-operator>) - Applies the provided call-operator against the linked data of the provided relation-name
         web::json::value rel(const nmos::resources& resources, const rql::evaluator& eval, const web::json::value& args)
         {
             return relation_query(eval, args, [&resources](const utility::string_t& relation_name, const web::json::value& relation_value)
             {
-                if (relation_value.is_string())
-                {
-                    // initially support relation-names that are the '<type>_id' properties, such as a sender's flow_id
-                    // and the 'subscription.sender_id' property of receivers (and vice-versa of senders)
-                    // other candidates are more complicated for various reasons...
-                    // for the 'parents' properties of sources and flows, the resource type is also needed
-                    // for 'interface_bindings' and 'clock_name', device_id and node_id are also needed to identify the node resource
-                    // some 'href' properties like the 'manifest_href' of a sender could be interesting
-                    nmos::type relation_type{ erase_tail_copy(relation_name.substr(relation_name.find_last_of(U('.')) + 1), U("_id")) };
-                    nmos::id relation_id{ relation_value.as_string() };
-
-                    auto found = find_resource(resources, { relation_id, relation_type });
-                    if (resources.end() == found) return rql::value_indeterminate;
-
-                    // return the linked value
-                    return found->data;
-                }
-                return web::json::value::object();
+                return *find_rel(resources, relation_name, relation_value);
             });
         }
 
@@ -338,12 +368,7 @@ namespace nmos
         {
             return relation_query(eval, args, [](const utility::string_t& relation_name, const web::json::value& relation_value)
             {
-                if (relation_value.is_object())
-                {
-                    // effectively just changes the extractor context to a sub-object
-                    return relation_value;
-                }
-                return web::json::value::object();
+                return *find_sub(relation_value);
             });
         }
     }
@@ -370,6 +395,28 @@ namespace nmos
         }
     }
 
+    // evaluate the compiled plan of an Advanced Query, see nmos::resource_query
+    static bool match_rql(const web::json::value& value, const rql::query_plan& plan, const nmos::resources& resources)
+    {
+        try
+        {
+            // 'rel' and 'sub' are compiled into the plan, but other call-operators may need to be evaluated in the usual way
+            return plan(value, [&resources](const utility::string_t& relation_operator, const utility::string_t& relation_name, const web::json::value& relation_value)
+            {
+                return U("rel") == relation_operator
+                    ? experimental::find_rel(resources, relation_name, relation_value)
+                    : experimental::find_sub(relation_value);
+            }, [&resources]
+            {
+                return make_rql_operators(resources);
+            }) ? true : false;
+        }
+        catch (const std::runtime_error&) // i.e. rql::details::rql_exception
+        {
+            return false;
+        }
+    }
+
     resource_query::result_type resource_query::operator()(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data, const nmos::resources& resources) const
     {
         // in theory, should be performing match_query against the downgraded resource_data but
@@ -378,7 +425,7 @@ namespace nmos
             && (resource_path.empty() || resource_path == U('/') + nmos::resourceType_from_type(resource_type))
             && nmos::is_permitted_downgrade(resource_version, resource_downgrade_version, resource_type, version, downgrade_version)
             && web::json::match_query(resource_data, basic_query, match_flags)
-            && match_rql(resource_data, rql_query, resources);
+            && (rql_query.is_null() || match_rql(resource_data, rql_plan, resources));
     }
 
     web::json::value resource_query::downgrade(const nmos::api_version& resource_version, const nmos::api_version& resource_downgrade_version, const nmos::type& resource_type, const web::json::value& resource_data) const
@@ -389,6 +436,55 @@ namespace nmos
         return nmos::downgrade(resource_version, resource_downgrade_version, resource_type, resource_data, version, downgrade_version);
     }
 
+    namespace details
+    {
+        bool resource_representation_cache::find(const key_type& key, const nmos::tai& updated, utility::string_t& representation)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto found = representations.find(key);
+            if (representations.end() == found) return false;
+            if (found->second.updated != updated)
+            {
+                // the resource has been modified since the representation was inserted
+                recency.erase(found->second.recency);
+                representations.erase(found);
+                return false;
+            }
+            recency.splice(recency.begin(), recency, found->second.recency);
+            representation = found->second.representation;
+            return true;
+        }
+
+        void resource_representation_cache::insert(const key_type& key, const nmos::tai& updated, const utility::string_t& representation)
+        {
+            if (0 == max_size) return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto found = representations.find(key);
+            if (representations.end() != found)
+            {
+                found->second.updated = updated;
+                found->second.representation = representation;
+                recency.splice(recency.begin(), recency, found->second.recency);
+                return;
+            }
+
+            while (max_size <= representations.size())
+            {
+                representations.erase(recency.back());
+                recency.pop_back();
+            }
+            recency.push_front(key);
+            representations.insert({ key, entry{ updated, representation, recency.begin() } });
+        }
+
+        size_t resource_representation_cache::size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return representations.size();
+        }
+    }
+
     // Helpers for constructing /subscriptions websocket grains
 
     namespace details
@@ -422,6 +518,70 @@ namespace nmos
             return result;
         }
 
+        std::string serialize_grain_message(const web::json::value& message, const std::string& serialized_grain_data)
+        {
+            using web::json::value;
+
+            // copy everything but the grain data, which is made the last field, in order to be replaced by the serialized grain data
+            value envelope = value::object(true);
+            for (const auto& field : message.as_object())
+            {
+                if (U("grain") == field.first) continue;
+                envelope[field.first] = field.second;
+            }
+            value& grain = envelope[U("grain")] = value::object(true);
+            for (const auto& field : message.at(U("grain")).as_object())
+            {
+                if (U("data") == field.first) continue;
+                grain[field.first] = field.second;
+            }
+            grain[U("data")] = value::array();
+
+            auto result = utility::us2s(envelope.serialize());
+            // i.e. "[]}}"
+            const std::string::size_type placeholder_size = 2, suffix_size = 2;
+            result.replace(result.size() - placeholder_size - suffix_size, placeholder_size, serialized_grain_data);
+            return result;
+        }
+
+        // prepare the message of the specified grain to be sent, with up to the specified number of pending resource events, see nmos::take_resource_events,
+        // and the specified timestamps
+        // any other events in the grain data are postponed, and returned so that they can be restored by nmos::details::reset_grain_message
+        // once the message has been sent
+        web::json::value prepare_grain_message(nmos::resources& resources, const nmos::resources::iterator& grain, size_t limit, const web::json::value& origin_timestamp, const web::json::value& creation_timestamp)
+        {
+            auto events = nmos::take_resource_events(resources, grain, limit);
+            auto postponed_events = web::json::value::array();
+
+            resources.modify(grain, [&](nmos::resource& grain)
+            {
+                auto& message = nmos::fields::message(grain.data);
+
+                // the events which weren't taken remain in the grain data, so must be set aside while the message is sent
+                using std::swap;
+                swap(postponed_events, nmos::fields::grain_data(message));
+                swap(nmos::fields::grain_data(message), events);
+
+                // set the timestamps
+                message[nmos::fields::origin_timestamp] = origin_timestamp;
+                message[nmos::fields::sync_timestamp] = origin_timestamp;
+                message[nmos::fields::creation_timestamp] = creation_timestamp;
+            });
+
+            return postponed_events;
+        }
+
+        // reset the message of the specified grain once it has been sent, restoring the postponed resource events
+        void reset_grain_message(nmos::resources& resources, const nmos::resources::iterator& grain, web::json::value&& postponed_events)
+        {
+            // there is no need to update the grain's timestamps, since events are recorded separately
+            resources.modify(grain, [&postponed_events](nmos::resource& grain)
+            {
+                using std::swap;
+                swap(nmos::fields::message_grain_data(grain.data), postponed_events);
+            });
+        }
+
         web::json::value make_resource_event(const utility::string_t& resource_path, const nmos::type& type, const web::json::value& pre, const web::json::value& post)
         {
             // !resource_path.empty() must imply resource_path == U('/') + nmos::resourceType_from_type(type)
@@ -437,6 +597,232 @@ namespace nmos
             return result;
         }
 
+        // experimental extension, for the query.patch flag
+        static web::json::value make_resource_patch_event(const utility::string_t& resource_path, const nmos::type& type, const web::json::value& pre, const web::json::value& post)
+        {
+            // seems worthwhile to keep_order for simple visualisation
+            web::json::value result = web::json::value::object(true);
+
+            const auto id = nmos::fields::id(post);
+            result[U("path")] = web::json::value::string(resource_path.empty() ? nmos::resourceType_from_type(type) + U('/') + id : id);
+            result[U("patch")] = web::json::diff(pre, post);
+
+            return result;
+        }
+
+        // determine the route of a subscription from its compiled query
+        static subscription_routes::route make_subscription_route(const resource_query& match)
+        {
+            subscription_routes::route result{ match.resource_path, {}, {} };
+
+            // only an exact, case-sensitive, string match on a property with a specific resource path can be indexed
+            if (match.resource_path.empty() || web::json::match_default != match.match_flags) return result;
+
+            for (const auto& field : match.basic_query.as_object())
+            {
+                if (field.second.is_string())
+                {
+                    result.property = field.first;
+                    result.value = field.second.as_string();
+                    break;
+                }
+            }
+            return result;
+        }
+
+        static void insert_subscription_route(subscription_routes& routes, const nmos::id& id, subscription_routes::route&& route)
+        {
+            if (route.property.empty())
+            {
+                routes.by_resource_path[route.resource_path].insert(id);
+            }
+            else
+            {
+                routes.by_property[route.resource_path][route.property][route.value].insert(id);
+            }
+            routes.routes[id] = std::move(route);
+        }
+
+        static void erase_subscription_route(subscription_routes& routes, const nmos::id& id)
+        {
+            auto found = routes.routes.find(id);
+            if (routes.routes.end() == found) return;
+
+            const auto& route = found->second;
+
+            // tidy up as we go, so that no time is wasted looking up properties which no subscription requires
+            if (route.property.empty())
+            {
+                auto by_resource_path = routes.by_resource_path.find(route.resource_path);
+                by_resource_path->second.erase(id);
+                if (by_resource_path->second.empty()) routes.by_resource_path.erase(by_resource_path);
+            }
+            else
+            {
+                auto by_resource_path = routes.by_property.find(route.resource_path);
+                auto by_property = by_resource_path->second.find(route.property);
+                auto by_value = by_property->second.find(route.value);
+                by_value->second.erase(id);
+                if (by_value->second.empty()) by_property->second.erase(by_value);
+                if (by_property->second.empty()) by_resource_path->second.erase(by_property);
+                if (by_resource_path->second.empty()) routes.by_property.erase(by_resource_path);
+            }
+
+            routes.routes.erase(found);
+        }
+
+        // compile the query for the specified subscription and cache it in the specified resources, or drop it if the subscription has been deleted or expired
+        // and likewise update the subscription's route in the index used by nmos::insert_resource_events
+        void update_subscription_query(nmos::resources& resources, const nmos::resource& subscription)
+        {
+            if (nmos::types::subscription != subscription.type) return;
+
+            erase_subscription_route(resources.subscription_routes, subscription.id);
+
+            if (!subscription.has_data())
+            {
+                resources.subscription_queries.erase(subscription.id);
+                return;
+            }
+
+            try
+            {
+                auto match = std::make_shared<const resource_query>(subscription.version, nmos::fields::resource_path(subscription.data), nmos::fields::params(subscription.data));
+                insert_subscription_route(resources.subscription_routes, subscription.id, make_subscription_route(*match));
+                resources.subscription_queries[subscription.id] = std::move(match);
+            }
+            catch (const std::exception&)
+            {
+                // the query parameters are not supported, so leave it to get_subscription_query to report the error
+                // but make sure the subscription is not overlooked
+                resources.subscription_queries.erase(subscription.id);
+                insert_subscription_route(resources.subscription_routes, subscription.id, { {}, {}, {} });
+            }
+        }
+
+        // get the ids of the subscriptions which might match the specified "pre" or "post" values of a resource of the specified type
+        std::vector<nmos::id> get_candidate_subscriptions(const nmos::resources& resources, const nmos::type& type, const web::json::value& pre, const web::json::value& post)
+        {
+            std::vector<nmos::id> result;
+
+            const auto& routes = resources.subscription_routes;
+            if (routes.routes.empty()) return result;
+
+            const auto insert = [&result](const std::set<nmos::id>& ids)
+            {
+                result.insert(result.end(), ids.begin(), ids.end());
+            };
+
+            // subscriptions to all resource types
+            auto all = routes.by_resource_path.find({});
+            if (routes.by_resource_path.end() != all) insert(all->second);
+
+            if (routes.by_resource_path.size() != (routes.by_resource_path.end() != all ? 1 : 0) || !routes.by_property.empty())
+            {
+                const auto resource_path = U('/') + nmos::resourceType_from_type(type);
+
+                // unindexed subscriptions to this resource type
+                auto unindexed = routes.by_resource_path.find(resource_path);
+                if (routes.by_resource_path.end() != unindexed) insert(unindexed->second);
+
+                // indexed subscriptions to this resource type
+                auto indexed = routes.by_property.find(resource_path);
+                if (routes.by_property.end() != indexed)
+                {
+                    for (const auto& by_property : indexed->second)
+                    {
+                        for (const auto& data : { std::cref(pre), std::cref(post) })
+                        {
+                            const auto& value = data.get();
+                            if (!value.is_object() || !value.has_field(by_property.first)) continue;
+
+                            const auto& property_value = value.at(by_property.first);
+                            if (property_value.is_string())
+                            {
+                                auto by_value = by_property.second.find(property_value.as_string());
+                                if (by_property.second.end() != by_value) insert(by_value->second);
+                            }
+                            else
+                            {
+                                // web::json::match_query is more permissive for arrays, etc.
+                                for (const auto& by_value : by_property.second)
+                                {
+                                    insert(by_value.second);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        }
+
+        // check whether any subscription might match a resource of the specified type, whatever its "pre" or "post" values
+        bool has_candidate_subscriptions(const nmos::resources& resources, const nmos::type& type)
+        {
+            if (!is_queryable_resource(type)) return false;
+
+            const auto& routes = resources.subscription_routes;
+            if (routes.routes.empty()) return false;
+
+            // subscriptions to all resource types
+            if (routes.by_resource_path.end() != routes.by_resource_path.find({})) return true;
+
+            // unindexed or indexed subscriptions to this resource type
+            const auto resource_path = U('/') + nmos::resourceType_from_type(type);
+            return routes.by_resource_path.end() != routes.by_resource_path.find(resource_path)
+                || routes.by_property.end() != routes.by_property.find(resource_path);
+        }
+
+        // get the compiled query for the specified subscription, constructing it if it has not been cached
+        std::shared_ptr<const nmos::resource_query> get_subscription_query(const nmos::resources& resources, const nmos::resource& subscription)
+        {
+            auto found = resources.subscription_queries.find(subscription.id);
+            if (resources.subscription_queries.end() != found && subscription.version == found->second->version) return found->second;
+
+            return std::make_shared<const resource_query>(subscription.version, nmos::fields::resource_path(subscription.data), nmos::fields::params(subscription.data));
+        }
+
+        // make the JSON resource event for a recorded grain event, according to the subscription's query
+        web::json::value make_resource_event(const nmos::resource_query& match, const grain_event& event)
+        {
+            using web::json::value;
+
+            // note: downgrade just returns a copy in the case that version <= match.version
+            const auto pre = event.pre ? match.downgrade(event.version, event.downgrade_version, event.type, *event.pre) : value::null();
+            const auto post = event.post ? match.downgrade(event.version, event.downgrade_version, event.type, *event.post) : value::null();
+
+            // experimental extension, for the query.patch flag
+            // a modified (or unchanged) resource is identified by the "path" and described by a JSON Patch from the "pre" to the "post" value
+            // which is typically much smaller than both values, e.g. for a receiver's subscription being activated
+            // the patch is made here, rather than when the event is recorded, so there's no cost for subscriptions that don't ask for it
+            auto result = match.patch && !pre.is_null() && !post.is_null()
+                ? make_resource_patch_event(match.resource_path, event.type, pre, post)
+                : make_resource_event(match.resource_path, event.type, pre, post);
+
+            // see explanation in nmos::make_resource_events
+            if (match.resource_path.empty())
+            {
+                if (!match.strip || event.version < match.version)
+                {
+                    result[nmos::experimental::fields::api_version] = value::string(nmos::make_api_version(event.version));
+                }
+            }
+
+            return result;
+        }
+
+        // drop the resource events recorded for the specified grain if it has been deleted or expired
+        void erase_grain_events(nmos::resources& resources, const nmos::resource& grain)
+        {
+            if (nmos::types::grain != grain.type || grain.has_data()) return;
+
+            resources.grain_events.queues.erase(grain.id);
+        }
+
         // get the resource id and type from the grain topic and event "path"
         std::pair<nmos::id, nmos::type> get_resource_event_resource(const utility::string_t& topic, const web::json::value& event)
         {
@@ -449,9 +835,15 @@ namespace nmos
                 return{};
         }
 
-        // determine the type of the resource event from "pre" and "post"
+        // determine the type of the resource event from "pre" and "post", or "patch"
         resource_event_type get_resource_event_type(const web::json::value& event)
         {
+            // experimental extension, for the query.patch flag
+            if (event.has_field(U("patch")))
+            {
+                return 0 != event.at(U("patch")).size() ? resource_modified_event : resource_unchanged_event;
+            }
+
             const bool has_pre = event.has_field(U("pre"));
             const bool has_post = event.has_field(U("post"));
 
@@ -478,7 +870,14 @@ namespace nmos
     // optionally, make 'added' resource events instead of 'sync' events
     web::json::value make_resource_events(const nmos::resources& resources, const nmos::api_version& version, const utility::string_t& resource_path, const web::json::value& params, bool sync)
     {
-        const resource_query match(version, resource_path, params);
+        return make_resource_events(resources, resource_query(version, resource_path, params), sync);
+    }
+
+    // make the initial 'sync' resource events for a new grain, including all resources that match the specified query
+    // optionally, make 'added' resource events instead of 'sync' events
+    web::json::value make_resource_events(const nmos::resources& resources, const nmos::resource_query& match, bool sync)
+    {
+        const auto& resource_path = match.resource_path;
 
         std::vector<web::json::value> events;
 
@@ -529,52 +928,116 @@ namespace nmos
 
         if (!details::is_queryable_resource(type)) return;
 
-        auto& by_type = resources.get<tags::type>();
-        const auto subscriptions = by_type.equal_range(details::has_data(nmos::types::subscription));
-        for (auto it = subscriptions.first; subscriptions.second != it; ++it)
+        std::shared_ptr<const value> shared_pre;
+        std::shared_ptr<const value> shared_post;
+
+        // only the candidate subscriptions need to be evaluated
+        for (const auto& subscription_id : details::get_candidate_subscriptions(resources, type, pre, post))
         {
             // for each subscription
+            auto it = find_resource(resources, { subscription_id, nmos::types::subscription });
+            if (resources.end() == it) continue;
             const auto& subscription = *it;
 
+            // with websocket connections
+            if (subscription.sub_resources.empty()) continue;
+
             // check whether the resource_path matches the resource type and the query parameters match either the "pre" or "post" resource
 
-            const auto resource_path = nmos::fields::resource_path(subscription.data);
-            const resource_query match(subscription.version, resource_path, nmos::fields::params(subscription.data));
+            const auto query = details::get_subscription_query(resources, subscription);
+            const auto& match = *query;
 
             const bool pre_match = match(version, downgrade_version, type, pre, resources);
             const bool post_match = match(version, downgrade_version, type, post, resources);
 
             if (!pre_match && !post_match) continue;
 
-            // add the event to the grain for each websocket connection to this subscription
+            // record the event for each websocket connection to this subscription
+            // the "pre" and "post" values are only copied once, however many subscriptions match, and the event is only made into JSON,
+            // and downgraded as necessary, when the message is sent
 
-            // note: downgrade just returns a copy in the case that version <= match.version
-            auto event = details::make_resource_event(resource_path, type,
-                pre_match ? match.downgrade(version, downgrade_version, type, pre) : value::null(),
-                post_match ? match.downgrade(version, downgrade_version, type, post) : value::null()
-                );
+            if (pre_match && !shared_pre) shared_pre = std::make_shared<const value>(pre);
+            if (post_match && !shared_post) shared_post = std::make_shared<const value>(post);
 
-            // see explanation in nmos::make_resource_events
-            if (resource_path.empty())
-            {
-                if (!match.strip || version < match.version)
-                {
-                    event[nmos::experimental::fields::api_version] = web::json::value::string(nmos::make_api_version(version));
-                }
-            }
+            const details::grain_event event{ version, downgrade_version, type, pre_match ? shared_pre : nullptr, post_match ? shared_post : nullptr };
 
             for (const auto& id : subscription.sub_resources)
             {
                 auto grain = find_resource(resources, { id, nmos::types::grain });
                 if (resources.end() == grain) continue; // check websocket connection is still open
 
-                resources.modify(grain, [&resources, &event](nmos::resource& grain)
-                {
-                    auto& events = nmos::fields::message_grain_data(grain.data);
-                    web::json::push_back(events, event);
-                    grain.updated = strictly_increasing_update(resources);
-                });
+                resources.grain_events.queues[grain->id].push_back(event);
+                ++resources.grain_events.count;
             }
         }
     }
+
+    // get the number of pending resource events for the specified grain
+    size_t count_resource_events(const nmos::resources& resources, const nmos::resource& grain)
+    {
+        const auto found = resources.grain_events.queues.find(grain.id);
+        const size_t recorded = resources.grain_events.queues.end() != found ? found->second.size() : 0;
+        return nmos::fields::message_grain_data(grain.data).size() + recorded;
+    }
+
+    // take up to the specified number of pending resource events for the specified grain, i.e. first any events in the grain data itself,
+    // then the events recorded by nmos::insert_resource_events, which are made into JSON according to the subscription's query
+    web::json::value take_resource_events(nmos::resources& resources, const nmos::resources::iterator& grain, size_t limit)
+    {
+        using web::json::value;
+
+        auto events = value::array();
+        auto& events_storage = web::json::storage_of(events.as_array());
+
+        // the grain data may include e.g. the initial 'sync' resource events, or IS-07 health messages
+        if (0 != nmos::fields::message_grain_data(grain->data).size())
+        {
+            resources.modify(grain, [&](nmos::resource& grain)
+            {
+                auto& grain_storage = web::json::storage_of(nmos::fields::message_grain_data(grain.data).as_array());
+                if (limit < grain_storage.size())
+                {
+                    const auto b = grain_storage.begin(), e = grain_storage.begin() + limit;
+                    events_storage.assign(std::make_move_iterator(b), std::make_move_iterator(e));
+                    grain_storage.erase(b, e);
+                }
+                else
+                {
+                    using std::swap;
+                    swap(events_storage, grain_storage);
+                }
+            });
+        }
+
+        auto found = resources.grain_events.queues.find(grain->id);
+        if (resources.grain_events.queues.end() == found) return events;
+        auto& queue = found->second;
+
+        const auto subscription = find_resource(resources, { nmos::fields::subscription_id(grain->data), nmos::types::subscription });
+        if (resources.end() == subscription)
+        {
+            // a grain without a subscription shouldn't be possible
+            resources.grain_events.queues.erase(found);
+            return events;
+        }
+        const auto query = details::get_subscription_query(resources, *subscription);
+
+        while (!queue.empty() && events_storage.size() < limit)
+        {
+            events_storage.push_back(details::make_resource_event(*query, queue.front()));
+            queue.pop_front();
+        }
+        if (queue.empty())
+        {
+            resources.grain_events.queues.erase(found);
+        }
+
+        return events;
+    }
+
+    // discard the resource events recorded for the specified grain, e.g. when the grain data is being reset with 'sync' resource events
+    void discard_resource_events(nmos::resources& resources, const nmos::resource& grain)
+    {
+        resources.grain_events.queues.erase(grain.id);
+    }
 }
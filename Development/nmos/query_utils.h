@@ -1,9 +1,13 @@
 #ifndef NMOS_QUERY_UTILS_H
 #define NMOS_QUERY_UTILS_H
 
-#include <boost/range/any_range.hpp>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include "nmos/paging_utils.h"
 #include "nmos/resources.h"
+#include "rql/rql.h"
 
 namespace nmos
 {
@@ -45,13 +49,43 @@ namespace nmos
         // whether resources of a higher API version are stripped of higher-version keys (false is experimental)
         bool strip;
 
+        // whether modified resource events are sent as a JSON Patch of "pre" to "post" rather than both values (experimental)
+        bool patch;
+
         // a representation of the RQL abstract syntax tree for an Advanced Query
         web::json::value rql_query;
 
+        // the compiled plan of the Advanced Query, so that it needn't be interpreted for every resource
+        rql::query_plan rql_plan;
+
         // flags that affect the Basic Query (experimental)
         web::json::match_flag_type match_flags;
     };
 
+    // evaluate an Advanced Query against the specified resource data by interpreting the RQL abstract syntax tree
+    // resource_query instead evaluates the compiled plan, which is much quicker when the same query is evaluated for many resources
+    bool match_rql(const web::json::value& value, const web::json::value& query, const nmos::resources& resources);
+
+    namespace details
+    {
+        // the extant resources of one type, in one of the composite (has_data, type, created/updated) indices
+        // which are in descending order of created/updated timestamp for each type, so are suitable for cursor-based paging
+        template <typename Tag>
+        struct resources_of_type
+        {
+            typedef typename nmos::resources::index<Tag>::type index_type;
+            typedef typename index_type::const_iterator iterator;
+            typedef iterator const_iterator;
+            typedef typename index_type::size_type size_type;
+
+            const index_type& index;
+            nmos::type type;
+
+            iterator begin() const { return index.lower_bound(has_data(type)); }
+            iterator end() const { return index.upper_bound(has_data(type)); }
+        };
+    }
+
     // Cursor-based paging parameters
     struct resource_paging
     {
@@ -76,16 +110,36 @@ namespace nmos
         // where a resulting data set is constrained by the server's value of 'limit'"
         bool since_specified;
 
+        // get the page of matching resources and update the paging parameters
+        // the predicate is evaluated once for each resource that needs to be considered, rather than each time the page is iterated
+        template <typename Predicate>
+        paging::evaluated_page<nmos::resource> page(const nmos::resources& resources, Predicate match)
+        {
+            if (order_by_created)
+            {
+                return paging::evaluated_cursor_based_page(resources.get<tags::created>(), match, until, since, limit, !since_specified);
+            }
+            else
+            {
+                return paging::evaluated_cursor_based_page(resources.get<tags::updated>(), match, until, since, limit, !since_specified);
+            }
+        }
+
+        // get the page of matching resources of the specified type and update the paging parameters
+        // this has the same result as the above when the predicate only matches resources of that type, e.g. when resource_query::resource_path is set,
+        // but only needs to consider the resources of that type
         template <typename Predicate>
-        boost::any_range<const nmos::resource, boost::bidirectional_traversal_tag, const nmos::resource&, std::ptrdiff_t> page(const nmos::resources& resources, Predicate match)
+        paging::evaluated_page<nmos::resource> page(const nmos::resources& resources, const nmos::type& type, Predicate match)
         {
             if (order_by_created)
             {
-                return paging::cursor_based_page(resources.get<tags::created>(), match, until, since, limit, !since_specified);
+                const details::resources_of_type<tags::type_created> range{ resources.get<tags::type_created>(), type };
+                return paging::evaluated_cursor_based_page(range, match, until, since, limit, !since_specified);
             }
             else
             {
-                return paging::cursor_based_page(resources.get<tags::updated>(), match, until, since, limit, !since_specified);
+                const details::resources_of_type<tags::type_updated> range{ resources.get<tags::type_updated>(), type };
+                return paging::evaluated_cursor_based_page(range, match, until, since, limit, !since_specified);
             }
         }
     };
@@ -104,6 +158,56 @@ namespace nmos
     inline nmos::resources::index<tags::created>::type::const_iterator lower_bound(const nmos::resources::index<tags::created>::type& index, const nmos::tai& timestamp) { return index.lower_bound(timestamp); }
     inline nmos::resources::index<tags::updated>::type::const_iterator lower_bound(const nmos::resources::index<tags::updated>::type& index, const nmos::tai& timestamp) { return index.lower_bound(timestamp); }
 
+    namespace details
+    {
+        inline nmos::tai extract_cursor(const resources_of_type<tags::type_created>&, resources_of_type<tags::type_created>::iterator it) { return it->created; }
+        inline nmos::tai extract_cursor(const resources_of_type<tags::type_updated>&, resources_of_type<tags::type_updated>::iterator it) { return it->updated; }
+
+        template <typename Tag>
+        inline typename resources_of_type<Tag>::iterator lower_bound(const resources_of_type<Tag>& range, const nmos::tai& timestamp) { return range.index.lower_bound(boost::make_tuple(true, range.type, timestamp)); }
+    }
+
+    namespace details
+    {
+        // Cache of the downgraded and serialized representations of resources, e.g. for the Query API and Node API
+        // Each representation is identified by the resource id, the requested API version and downgrade version, and whether the resource is stripped
+        // and is only used while the resource's updated timestamp is unchanged; an out-of-date representation is dropped when it is found
+        // When the cache reaches the maximum size, the least recently used representation is dropped, which also takes care of erased resources
+        // This is thread-safe since it is expected to be used by concurrent requests holding only a shared/read lock on the resources
+        class resource_representation_cache
+        {
+        public:
+            typedef std::tuple<nmos::id, nmos::api_version, nmos::api_version, bool> key_type;
+
+            // a maximum size of 0 disables the cache
+            explicit resource_representation_cache(size_t max_size = 65536) : max_size(max_size) {}
+
+            static key_type make_key(const nmos::resource& resource, const nmos::resource_query& match) { return key_type{ resource.id, match.version, match.downgrade_version, match.strip }; }
+
+            // get the cached representation, if it was inserted with the specified updated timestamp
+            bool find(const key_type& key, const nmos::tai& updated, utility::string_t& representation);
+
+            void insert(const key_type& key, const nmos::tai& updated, const utility::string_t& representation);
+
+            size_t size() const;
+
+        private:
+            struct entry
+            {
+                nmos::tai updated;
+                utility::string_t representation;
+                std::list<key_type>::iterator recency;
+            };
+
+            size_t max_size;
+
+            mutable std::mutex mutex;
+            // keys in order from the most recently to the least recently used
+            std::list<key_type> recency;
+            std::map<key_type, entry> representations;
+        };
+    }
+
     // Helpers for constructing /subscriptions websocket grains
     // See https://specs.amwa.tv/is-04/releases/v1.2.0/docs/4.2._Behaviour_-_Querying.html
 
@@ -111,9 +215,24 @@ namespace nmos
     // optionally, make 'added' resource events instead of 'sync' events
     web::json::value make_resource_events(const nmos::resources& resources, const nmos::api_version& version, const utility::string_t& resource_path, const web::json::value& params, bool sync = true);
 
+    // make the initial 'sync' resource events for a new grain, including all resources that match the specified query
+    // optionally, make 'added' resource events instead of 'sync' events
+    web::json::value make_resource_events(const nmos::resources& resources, const nmos::resource_query& match, bool sync = true);
+
     // insert 'added', 'removed' or 'modified' resource events into all grains whose subscriptions match the specified version, type and "pre" or "post" values
+    // the events are recorded in resources.grain_events rather than in the grain resources themselves, see nmos::take_resource_events
     void insert_resource_events(nmos::resources& resources, const nmos::api_version& version, const nmos::api_version& downgrade_version, const nmos::type& type, const web::json::value& pre, const web::json::value& post);
 
+    // get the number of pending resource events for the specified grain
+    size_t count_resource_events(const nmos::resources& resources, const nmos::resource& grain);
+
+    // take up to the specified number of pending resource events for the specified grain, i.e. first any events in the grain data itself,
+    // then the events recorded by nmos::insert_resource_events, which are made into JSON according to the subscription's query
+    web::json::value take_resource_events(nmos::resources& resources, const nmos::resources::iterator& grain, size_t limit = (std::numeric_limits<size_t>::max)());
+
+    // discard the resource events recorded for the specified grain, e.g. when the grain data is being reset with 'sync' resource events
+    void discard_resource_events(nmos::resources& resources, const nmos::resource& grain);
+
     namespace fields
     {
         const web::json::field_as_string_or query_rql{ U("query.rql"), {} };
@@ -130,6 +249,7 @@ namespace nmos
         namespace fields
         {
             const web::json::field_as_string_or query_strip{ U("query.strip"), {} };
+            const web::json::field_as_string_or query_patch{ U("query.patch"), {} };
         }
     }
 
@@ -147,7 +267,7 @@ namespace nmos
             resource_unchanged_event // also known as 'sync'
         };
 
-        // determine the type of the resource event from "pre" and "post"
+        // determine the type of the resource event from "pre" and "post", or "patch"
         resource_event_type get_resource_event_type(const web::json::value& event);
 
         // resource_path may be empty (matching all resource types) or e.g. "/nodes"
@@ -155,6 +275,42 @@ namespace nmos
 
         // make an empty grain
         web::json::value make_grain(const nmos::id& source_id, const nmos::id& flow_id, const utility::string_t& topic);
+
+        // serialize a grain message, using the already serialized grain data, so that identical events sent on many websocket connections
+        // need only be serialized once, while e.g. the flow_id and timestamps of each message differ
+        std::string serialize_grain_message(const web::json::value& message, const std::string& serialized_grain_data);
+
+        // prepare the message of the specified grain to be sent, with up to the specified number of pending resource events, see nmos::take_resource_events,
+        // and the specified timestamps
+        // any other events in the grain data are postponed, and returned so that they can be restored by nmos::details::reset_grain_message
+        // once the message has been sent
+        web::json::value prepare_grain_message(nmos::resources& resources, const nmos::resources::iterator& grain, size_t limit, const web::json::value& origin_timestamp, const web::json::value& creation_timestamp);
+
+        // reset the message of the specified grain once it has been sent, restoring the postponed resource events
+        void reset_grain_message(nmos::resources& resources, const nmos::resources::iterator& grain, web::json::value&& postponed_events);
+
+        // compile the query for the specified subscription and cache it in the specified resources, or drop it if the subscription has been deleted or expired
+        // and likewise update the subscription's route in the index of candidate subscriptions
+        // this is used by nmos::insert_resource, nmos::modify_resource, etc.
+        void update_subscription_query(nmos::resources& resources, const nmos::resource& subscription);
+
+        // get the ids of the subscriptions which might match the specified "pre" or "post" values of a resource of the specified type
+        // this is used by nmos::insert_resource_events, etc. to avoid evaluating the query of every subscription
+        std::vector<nmos::id> get_candidate_subscriptions(const nmos::resources& resources, const nmos::type& type, const web::json::value& pre, const web::json::value& post);
+
+        // check whether any subscription might match a resource of the specified type, whatever its "pre" or "post" values
+        // this is used by nmos::modify_resource to avoid taking a copy of the "pre" value when no resource events can result
+        bool has_candidate_subscriptions(const nmos::resources& resources, const nmos::type& type);
+
+        // get the compiled query for the specified subscription, constructing it if it has not been cached
+        std::shared_ptr<const nmos::resource_query> get_subscription_query(const nmos::resources& resources, const nmos::resource& subscription);
+
+        // make the JSON resource event for a recorded grain event, according to the subscription's query
+        web::json::value make_resource_event(const nmos::resource_query& match, const grain_event& event);
+
+        // drop the resource events recorded for the specified grain if it has been deleted or expired
+        // this is used by nmos::erase_resource, etc.
+        void erase_grain_events(nmos::resources& resources, const nmos::resource& grain);
     }
 }
 
@@ -8,6 +8,7 @@
 #include "nmos/scope.h"
 #include "nmos/slog.h"
 #include "nmos/version.h"
+#include "nmos/ws_api_utils.h"
 
 namespace nmos
 {
@@ -79,7 +80,7 @@ namespace nmos
 
                 // populate it with the initial (unchanged, a.k.a. sync) data
 
-                nmos::fields::message_grain_data(data) = make_resource_events(resources, subscription->version, resource_path, nmos::fields::params(subscription->data));
+                nmos::fields::message_grain_data(data) = make_resource_events(resources, *details::get_subscription_query(resources, *subscription));
 
                 // track the grain for the websocket connection as a sub-resource of the subscription
 
@@ -162,15 +163,17 @@ namespace nmos
         auto& resources = model.registry_resources;
 
         tai most_recent_message{};
+        std::uint64_t most_recent_event_count = 0;
         auto earliest_necessary_update = (tai_clock::time_point::max)();
 
         for (;;)
         {
-            // wait for the thread to be interrupted either because there are resource changes, or because the server is being shut down
+            // wait for the thread to be interrupted either because there are resource changes or events, or because the server is being shut down
             // or because message sending was throttled earlier
-            details::wait_until(condition, lock, earliest_necessary_update, [&] { return shutdown || most_recent_message < most_recent_update(resources); });
+            details::wait_until(condition, lock, earliest_necessary_update, [&] { return shutdown || most_recent_message < most_recent_update(resources) || most_recent_event_count < resources.grain_events.count; });
             if (shutdown) break;
             most_recent_message = most_recent_update(resources);
+            most_recent_event_count = resources.grain_events.count;
 
             slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Got notification on query websockets thread";
 
@@ -180,6 +183,11 @@ namespace nmos
 
             std::vector<std::pair<web::websockets::experimental::listener::connection_id, web::websockets::websocket_outgoing_message>> outgoing_messages;
 
+            // identical events, e.g. for subscriptions with the same resource path and query parameters, are only serialized once
+            details::serialization_cache serialized_grain_data;
+            // so the grains are only reset when all the messages have been prepared
+            std::vector<std::pair<nmos::resources::iterator, value>> grain_resets;
+
             for (auto wit = websockets.left.begin(); websockets.left.end() != wit;)
             {
                 const auto& websocket = *wit;
@@ -207,7 +215,8 @@ namespace nmos
                     continue;
                 }
                 // and has events to send
-                if (0 == nmos::fields::message_grain_data(grain->data).size())
+                const auto event_count = nmos::count_resource_events(resources, *grain);
+                if (0 == event_count)
                 {
                     ++wit;
                     continue;
@@ -232,7 +241,6 @@ namespace nmos
                 // experimental extension, to limit maximum number of events per message
 
                 resource_paging paging(nmos::fields::params(subscription->data), most_recent_message, (size_t)nmos::experimental::fields::query_ws_paging_default(model.settings), (size_t)nmos::experimental::fields::query_ws_paging_limit(model.settings));
-                auto next_events = value::array();
 
                 // determine the grain timestamps
 
@@ -250,28 +258,10 @@ namespace nmos
                 // or less recent since it hasn't been adjusted in the same way as the update timestamps
                 const auto creation_timestamp = value::string(nmos::make_version(tai_from_time_point(now)));
 
-                // prepare the message
-
-                resources.modify(grain, [&paging, &next_events, &origin_timestamp, &creation_timestamp](nmos::resource& grain)
-                {
-                    auto& message = nmos::fields::message(grain.data);
-
-                    // postpone all the events after the specified limit
-                    auto& next_storage = web::json::storage_of(next_events.as_array());
-                    auto& message_storage = web::json::storage_of(nmos::fields::grain_data(message).as_array());
-                    if (paging.limit < message_storage.size())
-                    {
-                        const auto b = message_storage.begin() + paging.limit, e = message_storage.end();
-                        next_storage.assign(std::make_move_iterator(b), std::make_move_iterator(e));
-                        message_storage.erase(b, e);
-                        // hmm, feels like origin_timestamp should be adjusted in this case, but how?
-                    }
-
-                    // set the timestamps
-                    message[nmos::fields::origin_timestamp] = origin_timestamp;
-                    message[nmos::fields::sync_timestamp] = origin_timestamp;
-                    message[nmos::fields::creation_timestamp] = creation_timestamp;
-                });
+                // prepare the message, postponing all the events after the specified limit
+                // hmm, feels like origin_timestamp should be adjusted in this case, but how?
+                auto postponed_events = details::prepare_grain_message(resources, grain, paging.limit, origin_timestamp, creation_timestamp);
+                const bool more_events = nmos::fields::message_grain_data(grain->data).size() < event_count;
 
                 slog::log<slog::severities::info>(gate, SLOG_FLF) << "Preparing to send " << nmos::fields::message_grain_data(grain->data).size() << " changes on websocket connection: " << grain->id;
 
@@ -299,13 +289,15 @@ namespace nmos
                 }
                 //- additional logging, cf. nmos::details::request_registration
 
-                auto serialized = utility::us2s(nmos::fields::message(grain->data).serialize());
+                const auto& grain_message = nmos::fields::message(grain->data);
+                const auto serialized_data = serialized_grain_data.serialize(nmos::fields::grain_data(grain_message), nmos::fields::grain_topic(grain_message));
+                auto serialized = details::serialize_grain_message(grain_message, *serialized_data);
                 web::websockets::websocket_outgoing_message message;
                 message.set_utf8_message(serialized);
 
                 outgoing_messages.push_back({ websocket.second, message });
 
-                if (0 != next_events.size())
+                if (more_events)
                 {
                     // make sure to send a message as soon as allowed
                     if (now + max_update_rate < earliest_necessary_update)
@@ -314,18 +306,19 @@ namespace nmos
                     }
                 }
 
-                // reset the grain for next time
-                resources.modify(grain, [&next_events, &resources](nmos::resource& grain)
-                {
-                    using std::swap;
-                    swap(nmos::fields::message_grain_data(grain.data), next_events);
-                    next_events = value::array(); // unnecessary
-                    grain.updated = strictly_increasing_update(resources);
-                });
+                grain_resets.push_back({ grain, std::move(postponed_events) });
 
                 ++wit;
             }
 
+            if (0 != serialized_grain_data.hits()) slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Reused the serialized events for " << serialized_grain_data.hits() << " websocket messages";
+
+            // reset the grains for next time, restoring any postponed events
+            for (auto& grain_reset : grain_resets)
+            {
+                details::reset_grain_message(resources, grain_reset.first, std::move(grain_reset.second));
+            }
+
             // send the messages without the lock on resources
             details::reverse_lock_guard<nmos::write_lock> unlock{ lock };
 
@@ -334,7 +327,9 @@ namespace nmos
             for (auto& outgoing_message : outgoing_messages)
             {
                 // hmmm, no way to cancel this currently...
-                auto send = listener.send(outgoing_message.first, outgoing_message.second).then([&](pplx::task<void> finally)
+                // don't wait for the message to be sent, since that may be delayed if the connection is congested, which mustn't hold up other connections
+                // the exception is observed using the underlying gate, since this thread's gate may not outlive the send
+                listener.send(outgoing_message.first, outgoing_message.second).then([&gate_](pplx::task<void> finally)
                 {
                     try
                     {
@@ -342,12 +337,9 @@ namespace nmos
                     }
                     catch (const web::websockets::websocket_exception& e)
                     {
-                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "WebSocket error: " << e.what() << " [" << e.error_code() << "]";
+                        slog::log<slog::severities::error>(gate_, SLOG_FLF) << "WebSocket error: " << e.what() << " [" << e.error_code() << "]";
                     }
                 });
-                // current websocket_listener implementation is synchronous in any case, but just to make clear...
-                // for now, wait for the message to be sent
-                send.wait();
             }
         }
     }
@@ -198,6 +198,395 @@ namespace nmos
         }
     }
 
+    namespace details
+    {
+        // a registration request for which the checks that only depend on the request itself have been done
+        struct registration_request
+        {
+            nmos::api_version version;
+            web::json::value data;
+            std::pair<nmos::id, nmos::type> id_type;
+            std::pair<nmos::id, nmos::type> super_id_type;
+            nmos::tai received;
+            utility::string_t client_id;
+        };
+
+        // the response to a registration request, which may be one of a batch
+        struct registration_response
+        {
+            web::http::status_code code;
+            // null unless the response has a body
+            web::json::value body;
+            web::http::http_headers headers;
+            // whether the resources have been modified
+            bool changed;
+        };
+
+        // validate the request body against the schema and extract the resource details
+        // this does not require the lock on the model to be held
+        registration_request make_registration_request(const web::json::experimental::json_validator& validator, const nmos::api_version& version, const web::json::value& body, const nmos::tai& received, const utility::string_t& client_id, bool allow_invalid_resources, slog::base_gate& gate)
+        {
+            // Validate JSON syntax according to the schema
+
+            if (!allow_invalid_resources)
+            {
+                validator.validate(body, experimental::make_registrationapi_resource_post_request_schema_uri(version));
+            }
+            else
+            {
+                try
+                {
+                    validator.validate(body, experimental::make_registrationapi_resource_post_request_schema_uri(version));
+                }
+                catch (const web::json::json_exception& e)
+                {
+                    slog::log<slog::severities::warning>(gate, SLOG_FLF) << "JSON error: " << e.what();
+                }
+            }
+
+            const web::json::value& data = nmos::fields::data(body);
+            const std::pair<nmos::id, nmos::type> id_type{ nmos::fields::id(data), nmos::type{ nmos::fields::type(body) } };
+
+            return{ version, data, id_type, nmos::get_super_resource(version, id_type.second, data), received, client_id };
+        }
+
+        // validate the request semantics, including referential integrity, and if valid, insert or modify the resource
+        // this requires the exclusive/write lock on the model to be held
+        registration_response register_resource(nmos::resources& resources, const registration_request& request, bool allow_invalid_resources, const utility::string_t& realm, slog::base_gate& gate)
+        {
+            using web::json::value;
+
+            const auto& version = request.version;
+            const auto& data = request.data;
+            const auto& id_type = request.id_type;
+            const auto& id = id_type.first;
+            const auto& type = id_type.second;
+            const auto& super_id_type = request.super_id_type;
+            const auto& received = request.received;
+            const auto& client_id = request.client_id;
+
+            const std::pair<nmos::id, nmos::type> no_resource{};
+
+            registration_response result{ web::http::status_codes::BadRequest, value::null(), {}, false };
+
+            // Validate request semantics, including referential integrity
+            // such as the requested super-resource
+
+            bool valid = true;
+
+            // a modification request must not change the existing type
+            auto resource = nmos::find_resource(resources, id);
+            const bool creating = resources.end() == resource;
+            const bool valid_type = creating || resource->type == type;
+            valid = valid && valid_type;
+
+            // a modification request must not change the API version
+            const bool valid_api_version = creating || resource->version == version;
+            valid = valid && valid_api_version;
+
+            // it must not change the super-resource either
+            const bool valid_super_id_type = creating || nmos::get_super_resource(*resource) == super_id_type;
+            valid = valid && valid_super_id_type;
+
+            // the super-resource should exist in this registry (and must be of the right type)
+            const auto super_resource = nmos::find_resource(resources, super_id_type.first);
+            const bool no_super_resource = resources.end() == super_resource;
+            const bool valid_super_resource = no_resource == super_id_type || !no_super_resource;
+            valid = valid && valid_super_resource;
+
+            const bool valid_super_type = no_resource == super_id_type || no_super_resource || super_resource->type == super_id_type.second;
+            valid = valid && valid_super_type;
+
+            // all the sub-resources of each node must have the same version
+            const bool valid_super_api_version = no_resource == super_id_type || no_super_resource || super_resource->version == version;
+            valid = valid && valid_super_api_version;
+
+            // registration of an unchanged resource is considered as an acceptable "update" even though it's a no-op, but seems worth logging?
+            const bool unchanged = !creating && data == resource->data;
+
+            // each modification of a resource should update the version timestamp
+            const bool valid_version = creating || unchanged || nmos::fields::version(data) > nmos::fields::version(resource->data);
+            valid = valid && valid_version;
+
+            // check received request isn't being processed out of order
+            const bool valid_received = creating || received == nmos::tai{} || received > resource->received;
+            valid = valid && valid_received;
+
+            if (!valid_received)
+                slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Registration requested for " << id_type << " at " << nmos::make_version(resource->received) << " processed before request received at " << nmos::make_version(received);
+            else if (!valid_type)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " would modify type from " << resource->type.name;
+            else if (!valid_api_version)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " would modify API version from " << nmos::make_api_version(resource->version);
+            else if (!valid_super_id_type)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " on " << super_id_type << " would modify super-resource from " << nmos::get_super_resource(*resource);
+            else if (!valid_super_resource)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " on unknown " << super_id_type;
+            else if (!valid_super_type)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " on " << super_id_type << " with inconsistent type of " << super_resource->type.name;
+            else if (!valid_super_api_version)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with API version inconsistent with super-resource " << nmos::make_api_version(super_resource->version);
+            else if (!valid_version)
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with invalid version";
+            else if (no_resource == super_id_type) // i.e. just nodes, basically
+                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Registration requested for " << (unchanged ? "unchanged " : "") << id_type;
+            else
+                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Registration requested for " << (unchanged ? "unchanged " : "") << id_type << " on " << super_id_type;
+
+            if (nmos::types::node == type)
+            {
+                // no extra validation yet
+            }
+            else if (nmos::types::device == type)
+            {
+                // "The 'senders' and 'receivers' arrays in a Device have been deprecated, but will continue to be present until v2.0."
+                // Therefore, issue warnings rather than errors here
+                // See https://specs.amwa.tv/is-04/releases/v1.2.1/docs/4.2._Behaviour_-_Querying.html#referential-integrity
+
+                for (auto& element : nmos::fields::senders(data))
+                {
+                    const auto& sender_id = element.as_string();
+                    const bool valid_sender = nmos::has_resource(resources, { sender_id, nmos::types::sender });
+                    if (!valid_sender) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown sender: " << sender_id;
+                }
+
+                for (auto& element : nmos::fields::receivers(data))
+                {
+                    const auto& receiver_id = element.as_string();
+                    const bool valid_receiver = nmos::has_resource(resources, { receiver_id, nmos::types::receiver });
+                    if (!valid_receiver) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown receiver: " << receiver_id;
+                }
+            }
+            else if (nmos::types::source == type)
+            {
+                // the parent sources might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
+                for (auto& element : nmos::fields::parents(data))
+                {
+                    const auto& source_id = element.as_string();
+                    const bool valid_parent = nmos::has_resource(resources, { source_id, nmos::types::source });
+                    if (!valid_parent) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown parent source: " << source_id;
+                }
+            }
+            else if (nmos::types::flow == type)
+            {
+                // v1.1 introduced device_id for flow, and uses it for referential integrity rather than source_id
+                // so if the source is not (yet) registered, issue a warning not an error, and don't treat this as invalid?
+                // see https://specs.amwa.tv/is-04/releases/v1.2.1/docs/4.1._Behaviour_-_Registration.html#referential-integrity
+                if (nmos::is04_versions::v1_1 <= version)
+                {
+                    const auto& source_id = nmos::fields::source_id(data);
+                    const bool valid_source = nmos::has_resource(resources, { source_id, nmos::types::source });
+                    if (!valid_source) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " from unknown source: " << source_id;
+                }
+
+                // the parent flows might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
+                for (auto& element : nmos::fields::parents(data))
+                {
+                    const auto& flow_id = element.as_string();
+                    const bool valid_parent = nmos::has_resource(resources, { flow_id, nmos::types::flow });
+                    if (!valid_parent) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown parent flow: " << flow_id;
+                }
+            }
+            else if (nmos::types::sender == type)
+            {
+                // v1.1 introduced null for flow_id to "permit Senders without attached Flows to model a Device before internal routing has been performed"
+                const auto& flow_id = nmos::fields::flow_id(data);
+                const bool valid_flow = flow_id.is_null() || nmos::has_resource(resources, { flow_id.as_string(), nmos::types::flow });
+                if (!valid_flow)
+                    slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " of unknown flow: " << flow_id.as_string();
+                else
+                    slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration requested for " << id_type << " of flow: " << details::as_string_or_null(flow_id);
+
+                // v1.2 introduced subscription for sender
+                if (nmos::is04_versions::v1_2 <= version)
+                {
+                    // the receiver might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
+                    const value& receiver_id = nmos::fields::receiver_id(nmos::fields::subscription(data));
+                    const bool valid_receiver = receiver_id.is_null() || nmos::has_resource(resources, { receiver_id.as_string(), nmos::types::receiver });
+                    if (!valid_receiver)
+                        slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to unknown receiver: " << receiver_id.as_string();
+                    else
+                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to receiver: " << details::as_string_or_null(receiver_id);
+                }
+            }
+            else if (nmos::types::receiver == type)
+            {
+                // the sender might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
+                const value& sender_id = nmos::fields::sender_id(nmos::fields::subscription(data));
+                const bool valid_sender = sender_id.is_null() || nmos::has_resource(resources, { sender_id.as_string(), nmos::types::sender });
+                if (!valid_sender)
+                    slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to unknown sender: " << sender_id.as_string();
+                else
+                    slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to sender: " << details::as_string_or_null(sender_id);
+            }
+            else // bad type
+            {
+                slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for unrecognised resource type: " << type.name;
+                valid = false;
+            }
+
+
+            // always reject updates that would modify resource type or super-resource
+            if (valid_type && valid_super_id_type && (valid || allow_invalid_resources))
+            {
+                if (creating)
+                {
+                    nmos::resource created_resource{ version, type, data, false, client_id };
+                    created_resource.received = received;
+
+                    result.code = web::http::status_codes::Created;
+                    result.body = data;
+                    result.headers.add(web::http::header_names::location, make_registration_api_resource_location(created_resource));
+
+                    resource = insert_resource(resources, std::move(created_resource), allow_invalid_resources).first;
+                }
+                // invalid Client ID, reject resource modification
+                // see https://specs.amwa.tv/bcp-003-02/releases/v1.0.0/docs/1.0._Authorization_Practice.html#registry-client-authorization
+                else if (client_id != resource->client_id)
+                {
+                    const auto error_description = details::make_valid_client_id_error(client_id);
+                    const utility::string_t auth_params{ U("Bearer realm=") + realm + U(",error=") + web::http::oauth2::experimental::resource_server_errors::insufficient_scope.name + U(",error_description=") + error_description };
+                    result.headers.add(web::http::header_names::www_authenticate, auth_params);
+                    result.code = web::http::status_codes::Forbidden;
+                    result.body = nmos::make_error_response_body(result.code, error_description);
+                }
+                else
+                {
+                    result.code = web::http::status_codes::OK;
+                    result.body = data;
+                    result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*resource));
+
+                    modify_resource(resources, id, [&received, &data](nmos::resource& resource)
+                    {
+                        resource.received = received;
+                        resource.data = data;
+                    });
+                }
+
+                // resource created/updated
+                if (client_id == resource->client_id)
+                {
+                    // experimental extension, for debugging
+                    result.headers.add(U("X-Paging-Timestamp"), make_version(resource->updated));
+
+                    result.changed = true;
+                }
+            }
+            else if (!valid_received)
+            {
+                result.code = web::http::status_codes::InternalError;
+            }
+            else if (!valid_api_version)
+            {
+                // experimental extension, proposed for v1.3, using a more specific status code to distinguish conflicts from validation errors
+                // when that conflict may be resolvable automatically by the Node
+                // see https://github.com/AMWA-TV/is-04/pull/85
+                result.code = web::http::status_codes::Conflict;
+                result.body = nmos::make_error_response_body(result.code, U("Conflict; ") + details::make_valid_api_version_error(version, resource->version));
+
+                // the Location header would enable an HTTP DELETE to be performed to explicitly clear the registry of the conflicting registration
+                // (assert !creating, i.e. resources.end() != resource in all these cases)
+                result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*resource));
+            }
+            else if (!valid_type)
+            {
+                // the following errors are more likely to require a human to investigate so result in a simple 400 response
+                // but provide additional information in the error body, and as an experimental extension, via the Location header
+                result.body = nmos::make_error_response_body(result.code, U("Bad Request; ") + details::make_valid_type_error(id_type, resource->type));
+                result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*resource));
+            }
+            else if (!valid_super_id_type)
+            {
+                result.body = nmos::make_error_response_body(result.code, U("Bad Request; ") + details::make_valid_super_id_type_error(super_id_type, nmos::get_super_resource(*resource)));
+                result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*resource));
+            }
+            else if (!valid_version)
+            {
+                result.body = nmos::make_error_response_body(result.code, U("Bad Request; ") + details::make_valid_version_error(nmos::fields::version(data), nmos::fields::version(resource->data)));
+                result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*resource));
+            }
+            else if (!valid_super_type)
+            {
+                // the difference here is that it's the super-resource that conflicts
+                result.body = nmos::make_error_response_body(result.code, U("Bad Request; ") + details::make_valid_super_type_error(super_id_type, super_resource->type));
+
+                // since the conflict is with the super-resource, a single HTTP DELETE cannot be enough to resolve the issue in this case...
+                // (assert !no_super_resource, i.e. resources.end() != super_resource in all these cases)
+                result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*super_resource));
+            }
+            else if (!valid_super_api_version)
+            {
+                // another super-resource conflict
+                result.body = nmos::make_error_response_body(result.code, U("Bad Request; ") + details::make_valid_super_api_version_error(version, super_resource->version));
+                result.headers.add(web::http::header_names::location, make_registration_api_resource_location(*super_resource));
+            }
+            else if (!valid_super_resource)
+            {
+                result.body = nmos::make_error_response_body(result.code, U("Bad Request; ") + details::make_valid_super_resource_error(super_id_type));
+            }
+
+            return result;
+        }
+
+        void set_registration_reply(web::http::http_response& res, const registration_response& response)
+        {
+            if (response.body.is_null())
+            {
+                set_reply(res, response.code);
+            }
+            else
+            {
+                set_reply(res, response.code, response.body);
+            }
+            for (const auto& header : response.headers)
+            {
+                res.headers().add(header.first, header.second);
+            }
+        }
+
+        // make the result for one registration request in the response to an experimental batch registration request
+        web::json::value make_batch_registration_result(const registration_response& response)
+        {
+            // use the standard error response body, in which the 'code' matches the HTTP status code, for errors
+            // but don't bother echoing back the data for successful requests
+            auto result = web::http::status_codes::BadRequest > response.code
+                ? web::json::value_of({ { U("code"), response.code } })
+                : !response.body.is_null() ? response.body : nmos::make_error_response_body(response.code);
+            if (response.headers.has(web::http::header_names::location))
+            {
+                result[U("location")] = web::json::value::string(response.headers.find(web::http::header_names::location)->second);
+            }
+            return result;
+        }
+
+        // get the time at which the request was received, if recorded by the listener
+        nmos::tai get_received_time(const web::http::http_request& req)
+        {
+            const auto received_time = req.headers().find(details::received_time);
+            return req.headers().end() != received_time ? nmos::parse_version(received_time->second) : nmos::tai{};
+        }
+
+        // Registry MUST register the Client ID of the client performing the registration. Subsequent requests to modify or delete a registered
+        // resource MUST validate the Client ID to ensure that clients do not, maliciously or incorrectly, alter resources belonging to other nodes
+        // see https://specs.amwa.tv/bcp-003-02/releases/v1.0.0/docs/1.0._Authorization_Practice.html#registry-client-authorization
+        utility::string_t get_registration_client_id(const web::http::http_request& req, bool server_authorization, slog::base_gate& gate)
+        {
+            // get client_id from header's access token
+            return server_authorization ? nmos::experimental::get_client_id(req.headers(), gate) : utility::string_t{};
+        }
+
+        // get the realm for the WWW-Authenticate header
+        utility::string_t get_realm(const web::http::http_request& req, const nmos::settings& settings)
+        {
+            auto req_host = web::http::get_host_port(req).first;
+            if (req_host.empty())
+            {
+                req_host = nmos::get_host(settings);
+            }
+            return req_host;
+        }
+    }
+
     inline web::http::experimental::listener::api_router make_unmounted_registration_api(nmos::registry_model& model, slog::base_gate& gate_)
     {
         using namespace web::http::experimental::listener::api_router_using_declarations;
@@ -220,9 +609,13 @@ namespace nmos
             return pplx::task_from_result(true);
         });
 
-        registration_api.support(U("/?"), methods::GET, [](http_request req, http_response res, const string_t&, const route_parameters&)
+        registration_api.support(U("/?"), methods::GET, [&model](http_request req, http_response res, const string_t&, const route_parameters&)
         {
-            set_reply(res, status_codes::OK, nmos::make_sub_routes_body({ U("resource/"), U("health/") }, req, res));
+            // experimental extension, the batch registration endpoint is advertised to Nodes by this listing
+            const auto batch_available = with_read_lock(model.mutex, [&model] { return nmos::experimental::fields::registration_batch_available(model.settings); });
+            std::set<utility::string_t> sub_routes{ U("resource/"), U("health/") };
+            if (batch_available) sub_routes.insert(U("x-batch/"));
+            set_reply(res, status_codes::OK, nmos::make_sub_routes_body(sub_routes, req, res));
             return pplx::task_from_result(true);
         });
 
@@ -239,311 +632,141 @@ namespace nmos
             // note that, as elsewhere, http_exception and json_exception are handled by the exception handler added by add_api_finally_handler
             return details::extract_json(req, gate).then([&model, &validator, req, res, parameters, gate](value body) mutable
             {
-                // could start out as a shared/read lock, only upgraded to an exclusive/write lock when the resource is actually modified or inserted into resources
-                auto lock = model.write_lock();
-                auto& resources = model.registry_resources;
+                // the request is processed in two stages; first, those checks which only depend on the request itself are done
+                // without holding the lock on the model, so that concurrent registrations don't serialise the Query API behind
+                // JSON schema validation; second, the referential-integrity checks and the update of the resources are done
+                // while holding the exclusive/write lock
 
                 const nmos::api_version version = nmos::parse_api_version(parameters.at(nmos::patterns::version.name));
 
-                // Validate JSON syntax according to the schema
-
-                const bool allow_invalid_resources = nmos::experimental::fields::allow_invalid_resources(model.settings);
-                if (!allow_invalid_resources)
-                {
-                    validator.validate(body, experimental::make_registrationapi_resource_post_request_schema_uri(version));
-                }
-                else
+                bool allow_invalid_resources = false;
+                bool server_authorization = false;
+                utility::string_t realm;
+                with_read_lock(model.mutex, [&]
                 {
-                    try
-                    {
-                        validator.validate(body, experimental::make_registrationapi_resource_post_request_schema_uri(version));
-                    }
-                    catch (const web::json::json_exception& e)
-                    {
-                        slog::log<slog::severities::warning>(gate, SLOG_FLF) << "JSON error: " << e.what();
-                    }
-                }
-
-                const value data = nmos::fields::data(body);
-                const std::pair<nmos::id, nmos::type> id_type{ nmos::fields::id(data), nmos::type{ nmos::fields::type(body) } };
-                const auto& id = id_type.first;
-                const auto& type = id_type.second;
+                    allow_invalid_resources = nmos::experimental::fields::allow_invalid_resources(model.settings);
+                    server_authorization = nmos::experimental::fields::server_authorization(model.settings);
+                    realm = details::get_realm(req, model.settings);
+                });
 
-                // Validate request semantics, including referential integrity
-                // such as the requested super-resource
+                const auto received = details::get_received_time(req);
+                const auto client_id = details::get_registration_client_id(req, server_authorization, gate);
 
-                bool valid = true;
+                const auto request = details::make_registration_request(validator, version, body, received, client_id, allow_invalid_resources, gate);
 
-                // a modification request must not change the existing type
-                auto resource = nmos::find_resource(resources, id);
-                const bool creating = resources.end() == resource;
-                const bool valid_type = creating || resource->type == type;
-                valid = valid && valid_type;
+                // could start out as a shared/read lock, only upgraded to an exclusive/write lock when the resource is actually modified or inserted into resources
+                auto lock = model.write_lock();
+                auto& resources = model.registry_resources;
 
-                // a modification request must not change the API version
-                const bool valid_api_version = creating || resource->version == version;
-                valid = valid && valid_api_version;
+                const auto response = details::register_resource(resources, request, allow_invalid_resources, realm, gate);
+                details::set_registration_reply(res, response);
 
-                // it must not change the super-resource either
-                const std::pair<nmos::id, nmos::type> no_resource{};
-                const auto super_id_type = nmos::get_super_resource(version, type, data);
-                const bool valid_super_id_type = creating || nmos::get_super_resource(*resource) == super_id_type;
-                valid = valid && valid_super_id_type;
+                if (response.changed)
+                {
+                    slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "At " << nmos::make_version(nmos::tai_now()) << ", the registry contains " << nmos::put_resources_statistics(resources);
 
-                // the super-resource should exist in this registry (and must be of the right type)
-                const auto super_resource = nmos::find_resource(resources, super_id_type.first);
-                const bool no_super_resource = resources.end() == super_resource;
-                const bool valid_super_resource = no_resource == super_id_type || !no_super_resource;
-                valid = valid && valid_super_resource;
+                    slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying query websockets thread"; // and anyone else who cares...
+                    model.notify();
+                }
 
-                const bool valid_super_type = no_resource == super_id_type || no_super_resource || super_resource->type == super_id_type.second;
-                valid = valid && valid_super_type;
+                return true;
+            });
+        });
 
-                // all the sub-resources of each node must have the same version
-                const bool valid_super_api_version = no_resource == super_id_type || no_super_resource || super_resource->version == version;
-                valid = valid && valid_super_api_version;
+        // experimental extension, to enable a Node to register many resources in one request, e.g. at start-up or after a registry restart
+        // the request body is an array of Registration API /resource request bodies, in referential order, which are processed in that order
+        // the response body is an array of the same size, in which each element has the 'code' that would have been the HTTP status code
+        // of the equivalent /resource response, and for errors, the 'error' and 'debug' information as well
 
-                // registration of an unchanged resource is considered as an acceptable "update" even though it's a no-op, but seems worth logging?
-                const bool unchanged = !creating && data == resource->data;
+        registration_api.support(U("/x-batch/?"), methods::GET, [&model](http_request req, http_response res, const string_t&, const route_parameters&)
+        {
+            const auto batch_available = with_read_lock(model.mutex, [&model] { return nmos::experimental::fields::registration_batch_available(model.settings); });
+            if (batch_available)
+            {
+                set_reply(res, status_codes::OK, nmos::make_sub_routes_body({ U("resource/") }, req, res));
+            }
+            else
+            {
+                set_reply(res, status_codes::NotFound);
+            }
+            return pplx::task_from_result(true);
+        });
 
-                // each modification of a resource should update the version timestamp
-                const bool valid_version = creating || unchanged || nmos::fields::version(data) > nmos::fields::version(resource->data);
-                valid = valid && valid_version;
+        registration_api.support(U("/x-batch/resource/?"), methods::POST, [&model, validator, &gate_](http_request req, http_response res, const string_t&, const route_parameters& parameters)
+        {
+            nmos::api_gate gate(gate_, req, parameters);
 
-                // check received request isn't being processed out of order
-                const auto received_time = req.headers().find(details::received_time);
-                const auto received = req.headers().end() != received_time ? nmos::parse_version(received_time->second) : nmos::tai{};
-                const bool valid_received = creating || received == nmos::tai{} || received > resource->received;
-                valid = valid && valid_received;
-
-                if (!valid_received)
-                    slog::log<slog::severities::severe>(gate, SLOG_FLF) << "Registration requested for " << id_type << " at " << nmos::make_version(resource->received) << " processed before request received at " << nmos::make_version(received);
-                else if (!valid_type)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " would modify type from " << resource->type.name;
-                else if (!valid_api_version)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " would modify API version from " << nmos::make_api_version(resource->version);
-                else if (!valid_super_id_type)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " on " << super_id_type << " would modify super-resource from " << nmos::get_super_resource(*resource);
-                else if (!valid_super_resource)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " on unknown " << super_id_type;
-                else if (!valid_super_type)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " on " << super_id_type << " with inconsistent type of " << super_resource->type.name;
-                else if (!valid_super_api_version)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with API version inconsistent with super-resource " << nmos::make_api_version(super_resource->version);
-                else if (!valid_version)
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with invalid version";
-                else if (no_resource == super_id_type) // i.e. just nodes, basically
-                    slog::log<slog::severities::info>(gate, SLOG_FLF) << "Registration requested for " << (unchanged ? "unchanged " : "") << id_type;
-                else
-                    slog::log<slog::severities::info>(gate, SLOG_FLF) << "Registration requested for " << (unchanged ? "unchanged " : "") << id_type << " on " << super_id_type;
+            return details::extract_json(req, gate).then([&model, &validator, req, res, parameters, gate](value body) mutable
+            {
+                const nmos::api_version version = nmos::parse_api_version(parameters.at(nmos::patterns::version.name));
 
-                if (nmos::types::node == type)
+                bool batch_available = false;
+                bool allow_invalid_resources = false;
+                bool server_authorization = false;
+                utility::string_t realm;
+                with_read_lock(model.mutex, [&]
                 {
-                    // no extra validation yet
-                }
-                else if (nmos::types::device == type)
-                {
-                    // "The 'senders' and 'receivers' arrays in a Device have been deprecated, but will continue to be present until v2.0."
-                    // Therefore, issue warnings rather than errors here
-                    // See https://specs.amwa.tv/is-04/releases/v1.2.1/docs/4.2._Behaviour_-_Querying.html#referential-integrity
+                    batch_available = nmos::experimental::fields::registration_batch_available(model.settings);
+                    allow_invalid_resources = nmos::experimental::fields::allow_invalid_resources(model.settings);
+                    server_authorization = nmos::experimental::fields::server_authorization(model.settings);
+                    realm = details::get_realm(req, model.settings);
+                });
 
-                    for (auto& element : nmos::fields::senders(data))
-                    {
-                        const auto& sender_id = element.as_string();
-                        const bool valid_sender = nmos::has_resource(resources, { sender_id, nmos::types::sender });
-                        if (!valid_sender) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown sender: " << sender_id;
-                    }
-
-                    for (auto& element : nmos::fields::receivers(data))
-                    {
-                        const auto& receiver_id = element.as_string();
-                        const bool valid_receiver = nmos::has_resource(resources, { receiver_id, nmos::types::receiver });
-                        if (!valid_receiver) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown receiver: " << receiver_id;
-                    }
-                }
-                else if (nmos::types::source == type)
+                if (!batch_available)
                 {
-                    // the parent sources might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
-                    for (auto& element : nmos::fields::parents(data))
-                    {
-                        const auto& source_id = element.as_string();
-                        const bool valid_parent = nmos::has_resource(resources, { source_id, nmos::types::source });
-                        if (!valid_parent) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown parent source: " << source_id;
-                    }
+                    set_reply(res, status_codes::NotFound);
+                    return true;
                 }
-                else if (nmos::types::flow == type)
-                {
-                    // v1.1 introduced device_id for flow, and uses it for referential integrity rather than source_id
-                    // so if the source is not (yet) registered, issue a warning not an error, and don't treat this as invalid?
-                    // see https://specs.amwa.tv/is-04/releases/v1.2.1/docs/4.1._Behaviour_-_Registration.html#referential-integrity
-                    if (nmos::is04_versions::v1_1 <= version)
-                    {
-                        const auto& source_id = nmos::fields::source_id(data);
-                        const bool valid_source = nmos::has_resource(resources, { source_id, nmos::types::source });
-                        if (!valid_source) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " from unknown source: " << source_id;
-                    }
 
-                    // the parent flows might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
-                    for (auto& element : nmos::fields::parents(data))
-                    {
-                        const auto& flow_id = element.as_string();
-                        const bool valid_parent = nmos::has_resource(resources, { flow_id, nmos::types::flow });
-                        if (!valid_parent) slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " with unknown parent flow: " << flow_id;
-                    }
-                }
-                else if (nmos::types::sender == type)
+                if (!body.is_array())
                 {
-                    // v1.1 introduced null for flow_id to "permit Senders without attached Flows to model a Device before internal routing has been performed"
-                    const auto& flow_id = nmos::fields::flow_id(data);
-                    const bool valid_flow = flow_id.is_null() || nmos::has_resource(resources, { flow_id.as_string(), nmos::types::flow });
-                    if (!valid_flow)
-                        slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " of unknown flow: " << flow_id.as_string();
-                    else
-                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration requested for " << id_type << " of flow: " << details::as_string_or_null(flow_id);
-
-                    // v1.2 introduced subscription for sender
-                    if (nmos::is04_versions::v1_2 <= version)
-                    {
-                        // the receiver might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
-                        const value& receiver_id = nmos::fields::receiver_id(nmos::fields::subscription(data));
-                        const bool valid_receiver = receiver_id.is_null() || nmos::has_resource(resources, { receiver_id.as_string(), nmos::types::receiver });
-                        if (!valid_receiver)
-                            slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to unknown receiver: " << receiver_id.as_string();
-                        else
-                            slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to receiver: " << details::as_string_or_null(receiver_id);
-                    }
-                }
-                else if (nmos::types::receiver == type)
-                {
-                    // the sender might not be registered in this registry, so issue a warning not an error, and don't treat this as invalid?
-                    const value& sender_id = nmos::fields::sender_id(nmos::fields::subscription(data));
-                    const bool valid_sender = sender_id.is_null() || nmos::has_resource(resources, { sender_id.as_string(), nmos::types::sender });
-                    if (!valid_sender)
-                        slog::log<slog::severities::warning>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to unknown sender: " << sender_id.as_string();
-                    else
-                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "Registration requested for " << id_type << " subscribed to sender: " << details::as_string_or_null(sender_id);
-                }
-                else // bad type
-                {
-                    slog::log<slog::severities::error>(gate, SLOG_FLF) << "Registration requested for unrecognised resource type: " << type.name;
-                    valid = false;
+                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; batch registration request body must be an array"));
+                    return true;
                 }
 
-                // always reject updates that would modify resource type or super-resource
-                if (valid_type && valid_super_id_type && (valid || allow_invalid_resources))
-                {
-                    // Registry MUST register the Client ID of the client performing the registration. Subsequent requests to modify or delete a registered
-                    // resource MUST validate the Client ID to ensure that clients do not, maliciously or incorrectly, alter resources belonging to other nodes
-                    // see https://specs.amwa.tv/bcp-003-02/releases/v1.0.0/docs/1.0._Authorization_Practice.html#registry-client-authorization
-                    utility::string_t client_id;
-                    if (nmos::experimental::fields::server_authorization(model.settings))
-                    {
-                        // get client_id from header's access token
-                        client_id = nmos::experimental::get_client_id(req.headers(), gate);
-                    }
+                slog::log<slog::severities::info>(gate, SLOG_FLF) << "Batch registration requested for " << body.size() << " resources";
 
-                    if (creating)
-                    {
-                        nmos::resource created_resource{ version, type, data, false, client_id };
-                        created_resource.received = received;
+                const auto received = details::get_received_time(req);
+                const auto client_id = details::get_registration_client_id(req, server_authorization, gate);
 
-                        set_reply(res, status_codes::Created, data);
-                        res.headers().add(web::http::header_names::location, make_registration_api_resource_location(created_resource));
+                // as for a single registration, do the checks which only depend on the requests themselves without holding the lock
+                // a request which fails schema validation doesn't prevent the processing of the rest of the batch
 
-                        resource = insert_resource(resources, std::move(created_resource), allow_invalid_resources).first;
-                    }
-                    // invalid Client ID, reject resource modification
-                    // see https://specs.amwa.tv/bcp-003-02/releases/v1.0.0/docs/1.0._Authorization_Practice.html#registry-client-authorization
-                    else if (client_id != resource->client_id)
+                auto results = value::array(body.size());
+                std::vector<std::pair<size_t, details::registration_request>> requests;
+                requests.reserve(body.size());
+                for (size_t i = 0; i < body.size(); ++i)
+                {
+                    try
                     {
-                        auto req_host = web::http::get_host_port(req).first;
-                        if (req_host.empty())
-                        {
-                            req_host = nmos::get_host(model.settings);
-                        }
-                        const auto error_description = details::make_valid_client_id_error(client_id);
-                        const utility::string_t auth_params{ U("Bearer realm=") + req_host + U(",error=") + web::http::oauth2::experimental::resource_server_errors::insufficient_scope.name + U(",error_description=") + error_description };
-                        res.headers().add(web::http::header_names::www_authenticate, auth_params);
-                        set_error_reply(res, status_codes::Forbidden, error_description);
+                        requests.push_back({ i, details::make_registration_request(validator, version, body.at(i), received, client_id, allow_invalid_resources, gate) });
                     }
-                    else
+                    catch (const web::json::json_exception& e)
                     {
-                        set_reply(res, status_codes::OK, data);
-                        res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*resource));
-
-                        modify_resource(resources, id, [&received, &data](nmos::resource& resource)
-                        {
-                            resource.received = received;
-                            resource.data = data;
-                        });
+                        slog::log<slog::severities::error>(gate, SLOG_FLF) << "JSON error: " << e.what();
+                        results[i] = nmos::make_error_response_body(status_codes::BadRequest, {}, utility::s2us(e.what()));
                     }
+                }
 
-                    // resource created/updated
-                    if (client_id == resource->client_id)
-                    {
-                        // experimental extension, for debugging
-                        res.headers().add(U("X-Paging-Timestamp"), make_version(resource->updated));
-
-                        slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "At " << nmos::make_version(nmos::tai_now()) << ", the registry contains " << nmos::put_resources_statistics(resources);
+                auto lock = model.write_lock();
+                auto& resources = model.registry_resources;
 
-                        slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying query websockets thread"; // and anyone else who cares...
-                        model.notify();
-                    }
-                }
-                else if (!valid_received)
+                bool changed = false;
+                for (const auto& request : requests)
                 {
-                    set_reply(res, status_codes::InternalError);
+                    const auto response = details::register_resource(resources, request.second, allow_invalid_resources, realm, gate);
+                    results[request.first] = details::make_batch_registration_result(response);
+                    changed = changed || response.changed;
                 }
-                else if (!valid_api_version)
-                {
-                    // experimental extension, proposed for v1.3, using a more specific status code to distinguish conflicts from validation errors
-                    // when that conflict may be resolvable automatically by the Node
-                    // see https://github.com/AMWA-TV/is-04/pull/85
-                    set_error_reply(res, status_codes::Conflict, U("Conflict; ") + details::make_valid_api_version_error(version, resource->version));
 
-                    // the Location header would enable an HTTP DELETE to be performed to explicitly clear the registry of the conflicting registration
-                    // (assert !creating, i.e. resources.end() != resource in all these cases)
-                    res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*resource));
-                }
-                else if (!valid_type)
-                {
-                    // the following errors are more likely to require a human to investigate so result in a simple 400 response
-                    // but provide additional information in the error body, and as an experimental extension, via the Location header
-                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; ") + details::make_valid_type_error(id_type, resource->type));
-                    res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*resource));
-                }
-                else if (!valid_super_id_type)
-                {
-                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; ") + details::make_valid_super_id_type_error(super_id_type, nmos::get_super_resource(*resource)));
-                    res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*resource));
-                }
-                else if (!valid_version)
-                {
-                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; ") + details::make_valid_version_error(nmos::fields::version(data), nmos::fields::version(resource->data)));
-                    res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*resource));
-                }
-                else if (!valid_super_type)
-                {
-                    // the difference here is that it's the super-resource that conflicts
-                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; ") + details::make_valid_super_type_error(super_id_type, super_resource->type));
+                set_reply(res, status_codes::OK, results);
 
-                    // since the conflict is with the super-resource, a single HTTP DELETE cannot be enough to resolve the issue in this case...
-                    // (assert !no_super_resource, i.e. resources.end() != super_resource in all these cases)
-                    res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*super_resource));
-                }
-                else if (!valid_super_api_version)
+                if (changed)
                 {
-                    // another super-resource conflict
-                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; ") + details::make_valid_super_api_version_error(version, super_resource->version));
-                    res.headers().add(web::http::header_names::location, make_registration_api_resource_location(*super_resource));
-                }
-                else if (!valid_super_resource)
-                {
-                    set_error_reply(res, status_codes::BadRequest, U("Bad Request; ") + details::make_valid_super_resource_error(super_id_type));
-                }
-                else
-                {
-                    set_reply(res, status_codes::BadRequest);
+                    slog::log<slog::severities::more_info>(gate, SLOG_FLF) << "At " << nmos::make_version(nmos::tai_now()) << ", the registry contains " << nmos::put_resources_statistics(resources);
+
+                    slog::log<slog::severities::too_much_info>(gate, SLOG_FLF) << "Notifying query websockets thread"; // and anyone else who cares...
+                    model.notify();
                 }
 
                 return true;
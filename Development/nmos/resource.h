@@ -3,7 +3,6 @@
 
 #include <set>
 #include "nmos/api_version.h"
-#include "nmos/copyable_atomic.h"
 #include "nmos/json_fields.h"
 #include "nmos/health.h"
 #include "nmos/id.h"
@@ -71,7 +70,8 @@ namespace nmos
         tai received;
 
         // see https://specs.amwa.tv/is-04/releases/v1.2.0/docs/4.1._Behaviour_-_Registration.html#heartbeating
-        mutable details::copyable_atomic<nmos::health> health;
+        // sub-resources usually inherit the health of their super-resource, see nmos::set_resource_health
+        mutable details::health_cell health;
 
         // Registry MUST register the Client ID of the client performing the registration. Subsequent requests to modify or delete a registered
         // resource MUST validate the Client ID to ensure that clients do not, maliciously or incorrectly, alter resources belonging to other nodes
@@ -1,11 +1,119 @@
 #include "nmos/resources.h"
 
-#include <boost/range/adaptor/reversed.hpp>
 #include "nmos/is04_versions.h"
 #include "nmos/query_utils.h"
 
 namespace nmos
 {
+    namespace details
+    {
+        // erase the recorded health of the specified resource from the health index (called with the index mutex locked)
+        static void erase_health(health_index& index, const id& id)
+        {
+            auto recorded = index.recorded.find(id);
+            if (index.recorded.end() == recorded) return;
+
+            auto bucket = index.buckets.find(recorded->second);
+            if (index.buckets.end() != bucket)
+            {
+                bucket->second.erase(id);
+                if (bucket->second.empty()) index.buckets.erase(bucket);
+            }
+            index.recorded.erase(recorded);
+        }
+
+        // record the health of the specified resource in the health index (called with the index mutex locked)
+        static void record_health(health_index& index, const id& id, health health)
+        {
+            erase_health(index, id);
+
+            // resources that never expire don't need to be recorded
+            if (health_forever == health) return;
+
+            index.recorded.insert({ id, health });
+            index.buckets[health].insert(id);
+        }
+
+        // make the specified resource, and all its sub-resources, inherit the specified health
+        static void inherit_health(const resources& resources, const id& id, const health_cell& health)
+        {
+            auto found = resources.find(id);
+            if (resources.end() != found && found->has_data())
+            {
+                for (auto& sub_resource : found->sub_resources)
+                {
+                    inherit_health(resources, sub_resource, health);
+                }
+
+                found->health.inherit(health);
+                found->health.subtree_inherits = true;
+            }
+        }
+
+        // the sub-resources of the super-resources of the specified resource can no longer all be assumed to inherit their health
+        static void invalidate_subtree_inherits(const resources& resources, const resource& resource)
+        {
+            auto super_resource = find_resource(resources, get_super_resource(resource));
+            while (resources.end() != super_resource)
+            {
+                super_resource->health.subtree_inherits = false;
+                super_resource = find_resource(resources, get_super_resource(*super_resource));
+            }
+        }
+
+        // a sub-resource which has the same health as its super-resource does not need to be recorded
+        // since it will expire along with the super-resource
+        static bool has_inherited_health(const resources& resources, const resource& resource, health health)
+        {
+            const auto super_resource = find_resource(resources, get_super_resource(resource));
+            return resources.end() != super_resource
+                && super_resource->health == health
+                && 0 != super_resource->sub_resources.count(resource.id);
+        }
+
+        // bring the least recorded health in the health index up-to-date, by re-recording (or dropping) the resources
+        // whose actual health is not the recorded health, until the least recorded health is the actual health
+        // of at least one resource, or the index is empty (called with the index mutex locked)
+        static void prune_health(const resources& resources, health_index& index)
+        {
+            while (!index.buckets.empty())
+            {
+                const auto bucket = index.buckets.begin();
+                const auto bucket_health = bucket->first;
+
+                bool up_to_date = false;
+                std::vector<std::pair<id, health>> stale;
+                for (const auto& id : bucket->second)
+                {
+                    const auto found = resources.find(id);
+                    if (resources.end() == found || !found->has_data())
+                    {
+                        stale.push_back({ id, health_forever });
+                        continue;
+                    }
+
+                    const auto health_snapshot = found->health.load();
+                    if (bucket_health == health_snapshot)
+                    {
+                        up_to_date = true;
+                    }
+                    else
+                    {
+                        stale.push_back({ id, has_inherited_health(resources, *found, health_snapshot) ? health_forever : health_snapshot });
+                    }
+                }
+
+                // this may erase the bucket
+                for (const auto& entry : stale)
+                {
+                    record_health(index, entry.first, entry.second);
+                }
+
+                if (up_to_date) break;
+            }
+        }
+    }
+
     // Resource creation/update/deletion operations
 
     // returns the most recent timestamp in the specified resources
@@ -16,23 +124,37 @@ namespace nmos
     }
 
     // returns the least health of extant and non-extant resources
-    // note, this is now O(N), not O(1), since resource health is mutable and therefore unindexed
+    // note, the least health of extant resources is found from the health index, which is brought up-to-date as necessary,
+    // while the non-extant resources, which are expected to be relatively few, are each checked
     std::pair<health, health> least_health(const resources& resources)
     {
         const auto now = health_now();
         std::pair<health, health> results{ now, now };
-        for (const auto& resource : resources)
+
         {
-            auto& result = resource.has_data() ? results.first : results.second;
+            auto& index = resources.health_index;
+            std::lock_guard<std::mutex> lock(index.mutex);
 
-            // since health is mutable, the snapshot may be immediately out of date
-            // but it is reasonable to rely on it not being modified to be *less*
-            const auto health_snapshot = resource.health.load();
-            if (health_snapshot < result)
+            // since health is mutable, the index may be immediately out of date
+            // but it is reasonable to rely on health not being modified to be *less*
+            details::prune_health(resources, index);
+            if (!index.buckets.empty() && index.buckets.begin()->first < results.first)
             {
-                result = health_snapshot;
+                results.first = index.buckets.begin()->first;
             }
         }
+
+        auto& by_type = resources.get<tags::type>();
+        const auto non_extant = by_type.equal_range(false);
+        for (auto resource = non_extant.first; non_extant.second != resource; ++resource)
+        {
+            const auto health_snapshot = resource->health.load();
+            if (health_snapshot < results.second)
+            {
+                results.second = health_snapshot;
+            }
+        }
+
         return results;
     }
 
@@ -81,15 +203,27 @@ namespace nmos
                 });
             }
 
+            details::update_subscription_query(resources, inserted);
+
             insert_resource_events(resources, inserted.version, inserted.downgrade_version, inserted.type, web::json::value::null(), inserted.data);
 
             // set the initial health of this resource from the super-resource (if applicable)
             // and update the health of any sub-resources to which the resource has been joined
-            // this may emit further resource events...
-            auto inserted_health = nmos::health_forever != inserted.health
-                ? super_resource != resources.end() ? super_resource->health.load() : inserted.created.seconds
-                : nmos::health_forever;
-            set_resource_health(resources, inserted.id, inserted_health);
+            if (nmos::health_forever == inserted.health)
+            {
+                // a resource which never expires doesn't inherit the health of its super-resource
+                details::invalidate_subtree_inherits(resources, inserted);
+                set_resource_health(resources, inserted.id, nmos::health_forever);
+            }
+            else if (super_resource != resources.end())
+            {
+                // no need to record the health of this resource in the health index, since it will expire along with the super-resource
+                details::inherit_health(resources, inserted.id, super_resource->health);
+            }
+            else
+            {
+                set_resource_health(resources, inserted.id, inserted.created.seconds);
+            }
         }
         // else logic error?
 
@@ -102,7 +236,12 @@ namespace nmos
         auto found = resources.find(id);
         if (resources.end() == found || !found->has_data()) return false;
 
-        auto pre = found->data;
+        // a copy of the "pre" value is only needed if a subscription could observe the modification
+        // (or the resource is itself a subscription, whose compiled query may need to be updated)
+        // which saves a deep copy of e.g. a large Node resource when nobody is interested
+        const bool observed = nmos::types::subscription == found->type || details::has_candidate_subscriptions(resources, found->type);
+        auto pre = observed ? found->data : web::json::value::null();
+        const auto pre_health = found->health.load();
 
         // "If an exception is thrown by some user-provided operation, then the element pointed to by position is erased."
         // This seems too surprising, despite the fact that it means that a modification may have been partially completed,
@@ -129,7 +268,23 @@ namespace nmos
         if (result)
         {
             auto& modified = *found;
-            insert_resource_events(resources, modified.version, modified.downgrade_version, modified.type, pre, modified.data);
+            if (observed)
+            {
+                if (pre != modified.data)
+                {
+                    details::update_subscription_query(resources, modified);
+                }
+
+                insert_resource_events(resources, modified.version, modified.downgrade_version, modified.type, pre, modified.data);
+            }
+
+            // the modifier may have set the health, e.g. so that a subscription which was being kept alive will now expire
+            const auto post_health = modified.health.load();
+            if (pre_health != post_health)
+            {
+                std::lock_guard<std::mutex> lock(resources.health_index.mutex);
+                details::record_health(resources.health_index, modified.id, post_health);
+            }
         }
 
         if (modifier_exception)
@@ -168,11 +323,22 @@ namespace nmos
 
                 // set the update timestamp when a resource is deleted
                 resource.updated = resource_updated;
+
+                // stop inheriting the health of the super-resource, which may remain extant
+                resource.health = resource.health.load();
             });
 
             auto& erased = *found;
+            details::update_subscription_query(resources, erased);
+            details::erase_grain_events(resources, erased);
+
             insert_resource_events(resources, erased.version, erased.downgrade_version, erased.type, pre, erased.data);
 
+            {
+                std::lock_guard<std::mutex> lock(resources.health_index.mutex);
+                details::erase_health(resources.health_index, erased.id);
+            }
+
             if (forget_now)
             {
                 resources.erase(found);
@@ -207,31 +373,27 @@ namespace nmos
         return count;
     }
 
-    // erase all resources of the specified type which expired *before* the specified time from the specified resources
-    // and return the count of the number of resources erased; sub-resources are *not* erased
-    // resources may optionally be initially "erased" by setting data to null, and remain in this non-extant state until they are explicitly forgotten (or reinserted)
-    // by default, the updated timestamp is not modified but this may be overridden
-    resources::size_type erase_expired_resources(resources& resources, const nmos::type& type, const health& expire_health, bool forget_now, bool set_updated)
+    namespace details
     {
-        resources::size_type count = 0;
-        auto& by_type = resources.get<tags::type>();
-        const auto range = by_type.equal_range(details::has_data(type));
-        auto found = range.first;
-        while (range.second != found)
+        // erase the specified resource and all its sub-resources which expired *before* the specified time
+        // and return the count of the number of resources erased
+        static resources::size_type erase_expired_resource(resources& resources, const id& id, const health& expire_health, bool forget_now, bool set_updated)
         {
-            if (expire_health <= found->health)
+            resources::size_type count = 0;
+            auto found = resources.find(id);
+            if (resources.end() != found && found->has_data() && found->health < expire_health)
             {
-                ++found;
-            }
-            else
-            {
-                // since modify reorders the resource in this index
-                const auto next = std::next(found);
+                // sub-resources are erased before super-resources, as by nmos::erase_resource
+                // a sub-resource which has not expired is left alone
+                for (auto& sub_resource : found->sub_resources)
+                {
+                    count += erase_expired_resource(resources, sub_resource, expire_health, forget_now, set_updated);
+                }
 
                 const auto pre = found->data;
 
                 auto resource_updated = nmos::strictly_increasing_update(resources);
-                by_type.modify(found, [&](resource& resource)
+                resources.modify(found, [&](resource& resource)
                 {
                     resource.data = web::json::value::null();
 
@@ -240,34 +402,65 @@ namespace nmos
                     {
                         resource.updated = resource_updated;
                     }
+
+                    // stop inheriting the health of the super-resource, which may not have expired
+                    resource.health = resource.health.load();
                 });
 
                 auto& erased = *found;
+                details::update_subscription_query(resources, erased);
+                details::erase_grain_events(resources, erased);
+
                 insert_resource_events(resources, erased.version, erased.downgrade_version, erased.type, pre, erased.data);
 
+                {
+                    std::lock_guard<std::mutex> lock(resources.health_index.mutex);
+                    details::erase_health(resources.health_index, erased.id);
+                }
+
                 if (forget_now)
                 {
-                    by_type.erase(found);
+                    resources.erase(found);
                 }
 
-                found = next;
                 ++count;
             }
+            return count;
         }
-        return count;
     }
 
     // erase all resources which expired *before* the specified time from the specified resources
     // and return the count of the number of resources erased
+    // only the resources in the health index which have expired, and their expired sub-resources, are visited
     // resources may optionally be initially "erased" by setting data to null, and remain in this non-extant state until they are explicitly forgotten (or reinserted)
     // by default, the updated timestamp is not modified but this may be overridden
     resources::size_type erase_expired_resources(resources& resources, const health& expire_health, bool forget_now, bool set_updated)
     {
         resources::size_type count = 0;
-        // reverse order to ensure sub-resources are erased before super-resources
-        for (const auto& type : nmos::types::all | boost::adaptors::reversed)
+        for (;;)
         {
-            count += erase_expired_resources(resources, type, expire_health, forget_now, set_updated);
+            std::vector<id> expired;
+            {
+                auto& index = resources.health_index;
+                std::lock_guard<std::mutex> lock(index.mutex);
+
+                details::prune_health(resources, index);
+                if (index.buckets.empty() || expire_health <= index.buckets.begin()->first) break;
+
+                // after pruning, every resource with the least recorded health has that health, so has expired
+                const auto bucket = index.buckets.begin();
+                expired.assign(bucket->second.begin(), bucket->second.end());
+                for (const auto& id : expired)
+                {
+                    index.recorded.erase(id);
+                }
+                index.buckets.erase(bucket);
+            }
+
+            for (const auto& id : expired)
+            {
+                count += details::erase_expired_resource(resources, id, expire_health, forget_now, set_updated);
+            }
         }
         return count;
     }
@@ -275,19 +468,39 @@ namespace nmos
     // find the resource with the specified id in the specified resources (if present) and
     // set the health of the resource and all of its sub-resources, to prevent them expiring
     // note, since health is mutable, no need for the resources parameter to be non-const
+    // usually, all the sub-resources already inherit the health of the resource, so this is a single atomic store
     void set_resource_health(const resources& resources, const id& id, health health)
     {
         auto found = resources.find(id);
         if (resources.end() != found && found->has_data())
         {
-            for (auto& sub_resource : found->sub_resources)
+            // since health is mutable, no need for:
+            // resources.modify(found, [&health](nmos::resource& resource){ resource.health = health; });
+
+            const auto super_resource = find_resource(resources, get_super_resource(*found));
+            if (resources.end() != super_resource && found->health.inherits(super_resource->health))
+            {
+                // stop inheriting the health of the super-resource
+                found->health = health;
+                details::invalidate_subtree_inherits(resources, *found);
+            }
+            else
             {
-                set_resource_health(resources, sub_resource, health);
+                found->health.store(health);
             }
 
-            // since health is mutable, no need for:
-            // resources.modify(found, [&health](nmos::resource& resource){ resource.health = health; });
-            found->health = health;
+            if (!found->health.subtree_inherits)
+            {
+                for (auto& sub_resource : found->sub_resources)
+                {
+                    details::inherit_health(resources, sub_resource, found->health);
+                }
+                found->health.subtree_inherits = true;
+            }
+
+            // only this resource is recorded in the health index, not its sub-resources
+            std::lock_guard<std::mutex> lock(resources.health_index.mutex);
+            details::record_health(resources.health_index, id, health);
         }
     }
 
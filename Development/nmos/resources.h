@@ -1,7 +1,16 @@
 #ifndef NMOS_RESOURCES_H
 #define NMOS_RESOURCES_H
 
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/composite_key.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -23,8 +32,12 @@ namespace nmos
         struct type;
         struct created;
         struct updated;
+        struct type_created;
+        struct type_updated;
     }
 
+    struct resource_query; // see nmos/query_utils.h
+
     namespace details
     {
         typedef boost::multi_index::member<resource, id, &resource::id> id_extractor;
@@ -32,24 +45,146 @@ namespace nmos
         typedef boost::tuple<bool, type> type_extractor_tuple;
         typedef boost::multi_index::member<resource, tai, &resource::created> created_extractor;
         typedef boost::multi_index::member<resource, tai, &resource::updated> updated_extractor;
+        typedef boost::multi_index::composite_key<resource, boost::multi_index::const_mem_fun<resource, bool, &resource::has_data>, boost::multi_index::member<resource, type, &resource::type>, created_extractor> type_created_extractor;
+        typedef boost::multi_index::composite_key<resource, boost::multi_index::const_mem_fun<resource, bool, &resource::has_data>, boost::multi_index::member<resource, type, &resource::type>, updated_extractor> type_updated_extractor;
+        typedef boost::multi_index::composite_key_compare<std::less<bool>, std::less<type>, std::greater<tai>> type_timestamp_compare;
 
         // extant resources have non-null data
         inline type_extractor_tuple has_data(const type& type) { return type_extractor_tuple{ true, type }; }
     }
 
-    // the id index ensures resource id is unique
-    // the type index is a composite index incorporating whether the resource has been deleted or expired
-    // the created/updated indices ensure uniqueness to satisfy the requirements of Query API cursor-based paging
-    // and are in descending order to simplify implementation
-    typedef boost::multi_index_container<
-        resource,
-        boost::multi_index::indexed_by<
-            boost::multi_index::hashed_unique<boost::multi_index::tag<tags::id>, details::id_extractor>,
-            boost::multi_index::ordered_non_unique<boost::multi_index::tag<tags::type>, details::type_extractor>,
-            boost::multi_index::ordered_unique<boost::multi_index::tag<tags::created>, details::created_extractor, std::greater<details::created_extractor::result_type>>,
-            boost::multi_index::ordered_unique<boost::multi_index::tag<tags::updated>, details::updated_extractor, std::greater<details::updated_extractor::result_type>>
-        >
-    > resources;
+    namespace details
+    {
+        // the id index ensures resource id is unique
+        // the type index is a composite index incorporating whether the resource has been deleted or expired
+        // the created/updated indices ensure uniqueness to satisfy the requirements of Query API cursor-based paging
+        // and are in descending order to simplify implementation
+        // the type_created/type_updated indices are equivalent composite indices for the resources of each type, so that paging
+        // a query for one type doesn't need to scan the resources of every other type
+        typedef boost::multi_index_container<
+            resource,
+            boost::multi_index::indexed_by<
+                boost::multi_index::hashed_unique<boost::multi_index::tag<tags::id>, details::id_extractor>,
+                boost::multi_index::ordered_non_unique<boost::multi_index::tag<tags::type>, details::type_extractor>,
+                boost::multi_index::ordered_unique<boost::multi_index::tag<tags::created>, details::created_extractor, std::greater<details::created_extractor::result_type>>,
+                boost::multi_index::ordered_unique<boost::multi_index::tag<tags::updated>, details::updated_extractor, std::greater<details::updated_extractor::result_type>>,
+                boost::multi_index::ordered_non_unique<boost::multi_index::tag<tags::type_created>, details::type_created_extractor, details::type_timestamp_compare>,
+                boost::multi_index::ordered_non_unique<boost::multi_index::tag<tags::type_updated>, details::type_updated_extractor, details::type_timestamp_compare>
+            >
+        > resources_container;
+
+        // the query for each subscription, compiled once when the subscription is inserted or modified rather than for every resource event
+        // see nmos::insert_resource_events
+        typedef std::unordered_map<nmos::id, std::shared_ptr<const resource_query>> subscription_queries;
+
+        // an index of the subscriptions, to route each resource event to only the candidate subscriptions
+        // rather than evaluating the query of every subscription
+        // see nmos::insert_resource_events
+        struct subscription_routes
+        {
+            // the route of a subscription is its resource path and, when the Basic Query requires an exact string match
+            // on a top-level property, e.g. "device_id" or "label", that property name and value
+            struct route
+            {
+                utility::string_t resource_path;
+                utility::string_t property;
+                utility::string_t value;
+            };
+
+            // the route of each subscription in the index
+            std::unordered_map<nmos::id, route> routes;
+
+            // subscriptions with a resource path and an exact string match, by resource path, property name and value
+            std::map<utility::string_t, std::map<utility::string_t, std::map<utility::string_t, std::set<nmos::id>>>> by_property;
+
+            // all other subscriptions, e.g. those with only an Advanced Query, by resource path (which may be empty, matching all resource types)
+            std::map<utility::string_t, std::set<nmos::id>> by_resource_path;
+        };
+
+        // a resource event recorded for the grain of a websocket connection, which is only made into JSON when the message is sent
+        // the "pre" and "post" values are null unless matched by the subscription's query, and otherwise are shared by every grain
+        // to which the event was routed
+        // see nmos::insert_resource_events and nmos::take_resource_events
+        struct grain_event
+        {
+            api_version version;
+            api_version downgrade_version;
+            nmos::type type;
+            std::shared_ptr<const web::json::value> pre;
+            std::shared_ptr<const web::json::value> post;
+        };
+
+        // the pending resource events for each grain, kept outside the resources container so that recording an event doesn't modify
+        // (and therefore reindex) the grain resource, and the total number of events ever recorded, so that a thread waiting for events
+        // can determine whether there are new ones
+        struct grain_events
+        {
+            grain_events() : count(0) {}
+
+            std::unordered_map<nmos::id, std::deque<grain_event>> queues;
+            std::uint64_t count;
+        };
+
+        // the indices of the IS-12 control protocol objects inserted by nmos::nc::insert_resource, so that an object can be found
+        // by its oid, by the role path of a block member, or by the id of an IS-04/IS-05/IS-08 resource which is one of its touchpoints,
+        // without searching every resource or walking the block member descriptors
+        // see nmos::nc::insert_resource, nmos::nc::erase_resource, nmos::nc::find_resource and nmos::nc::find_resource_by_role_path
+        struct control_protocol_objects
+        {
+            // the properties of an object which are indexed, all of which are read-only
+            struct object
+            {
+                nmos::id id;
+                bool has_owner;
+                std::uint32_t owner;
+                utility::string_t role;
+                std::vector<nmos::id> touchpoints;
+            };
+
+            // the indexed objects, by oid
+            std::unordered_map<std::uint32_t, object> objects;
+
+            // the oid of each object by the oid of the block which owns it and its role, i.e. a trie of the role paths
+            // in which each node is a block
+            std::unordered_map<std::uint32_t, std::unordered_map<utility::string_t, std::uint32_t>> members;
+
+            // the oid of each object by the id of each of its touchpoint resources
+            std::unordered_multimap<nmos::id, std::uint32_t> touchpoints;
+        };
+
+        // the recorded health of the resources, in buckets of the same health (in seconds), so that the least health can be found,
+        // and the expired resources erased, without going through every resource
+        // only the resource for which health is set is recorded, e.g. a node which has had a heartbeat, not each of its sub-resources;
+        // the recorded health of a resource may be less than its actual health (never more) since health can be increased without
+        // updating the index, and a sub-resource with the same health as its super-resource is not recorded once that has been noticed,
+        // since it will expire along with its super-resource
+        // since health is mutable and may be set with only a shared/read lock on the resources, the index has its own mutex
+        // see nmos::set_resource_health, nmos::least_health and nmos::erase_expired_resources
+        struct health_index
+        {
+            health_index() {}
+            health_index(const health_index& other) : recorded(other.recorded), buckets(other.buckets) {}
+            health_index& operator=(const health_index& other) { recorded = other.recorded; buckets = other.buckets; return *this; }
+
+            mutable std::mutex mutex;
+
+            // the recorded health of each resource
+            std::unordered_map<nmos::id, health> recorded;
+
+            // the resources with each recorded health, least first
+            std::map<health, std::unordered_set<nmos::id>> buckets;
+        };
+    }
+
+    // the resources container, together with some auxiliary state maintained by the resource creation/update/deletion operations
+    struct resources : details::resources_container
+    {
+        details::subscription_queries subscription_queries;
+        details::subscription_routes subscription_routes;
+        details::grain_events grain_events;
+        details::control_protocol_objects control_protocol_objects;
+        mutable details::health_index health_index;
+    };
 
     // Resource creation/update/deletion operations
 
@@ -63,7 +198,8 @@ namespace nmos
     }
 
     // returns the least health of extant and non-extant resources
-    // note, this is now O(N), not O(1), since resource health is mutable and therefore unindexed
+    // note, the least health of extant resources is found from the health index, which is brought up-to-date as necessary,
+    // while the non-extant resources, which are expected to be relatively few, are each checked
     std::pair<health, health> least_health(const resources& resources);
 
     // insert a resource (join_sub_resources can be false if related resources are known to be inserted in order)
@@ -84,6 +220,7 @@ namespace nmos
 
     // erase all resources which expired *before* the specified time from the specified resources
     // and return the count of the number of resources erased
+    // only the resources in the health index which have expired, and their expired sub-resources, are visited
     // resources may optionally be initially "erased" by setting data to null, and remain in this non-extant state until they are explicitly forgotten (or reinserted)
     // by default, the updated timestamp is not modified but this may be overridden
     resources::size_type erase_expired_resources(resources& resources, const health& expire_health, bool forget_now = true, bool set_updated = false);
@@ -118,6 +118,12 @@ namespace nmos
     {
         web::websockets::experimental::listener::websocket_listener_config config;
         config.set_backlog(nmos::fields::listen_backlog(settings));
+        config.set_thread_pool_size(nmos::experimental::fields::ws_listener_threads(settings));
+        config.set_send_buffer_limit((size_t)nmos::experimental::fields::ws_send_buffer_max(settings));
+        config.set_send_queue_limit((size_t)nmos::experimental::fields::ws_send_queue_max(settings));
+        config.set_send_queue_policy(U("drop_oldest") == nmos::experimental::fields::ws_send_queue_policy(settings)
+            ? web::websockets::experimental::listener::send_queue_policy::drop_oldest
+            : web::websockets::experimental::listener::send_queue_policy::disconnect);
 #if !defined(_WIN32) || !defined(__cplusplus_winrt)
         config.set_ssl_context_callback(details::make_listener_ssl_context_callback<web::websockets::websocket_exception>(settings, load_server_certificates, load_dh_param, get_ocsp_response, gate));
 #endif
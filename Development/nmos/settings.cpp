@@ -127,6 +127,7 @@ namespace nmos
         "discovery_backoff_min":    { "$ref": "#/definitions/nonNegativeInteger" },
         "discovery_backoff_max":    { "$ref": "#/definitions/nonNegativeInteger" },
         "discovery_backoff_factor": { "type": "number", "minimum": 1 },
+        "discovery_cache_interval": { "$ref": "#/definitions/nonNegativeInteger" },
 
         "service_name_prefix": { "type": "string" },
         "registry_address":    { "type": "string" },
@@ -165,11 +166,14 @@ namespace nmos
         "system_version":     { "$ref": "#/definitions/apiVersion" },
         "system_request_max": { "$ref": "#/definitions/positiveInteger" },
 
-        "seed_id":                 { "$ref": "#/definitions/uuid" },
-        "label":                   { "type": "string" },
-        "description":             { "type": "string" },
-        "registration_available":  { "type": "boolean" },
-        "allow_invalid_resources": { "type": "boolean" },
+        "seed_id":                      { "$ref": "#/definitions/uuid" },
+        "label":                        { "type": "string" },
+        "description":                  { "type": "string" },
+        "registration_available":       { "type": "boolean" },
+        "allow_invalid_resources":      { "type": "boolean" },
+        "registration_batch_available": { "type": "boolean" },
+        "registration_batch_max":       { "$ref": "#/definitions/nonNegativeInteger" },
+        "registration_request_window":  { "$ref": "#/definitions/positiveInteger" },
 
         "manifest_port":    { "$ref": "#/definitions/port" },
         "settings_port":    { "$ref": "#/definitions/port" },
@@ -188,6 +192,14 @@ namespace nmos
 
         "query_ws_paging_default": { "$ref": "#/definitions/positiveInteger" },
         "query_ws_paging_limit":   { "$ref": "#/definitions/positiveInteger" },
+
+        "representation_cache_max": { "$ref": "#/definitions/nonNegativeInteger" },
+
+        "ws_listener_threads":  { "$ref": "#/definitions/positiveInteger" },
+        "ws_send_buffer_max":   { "$ref": "#/definitions/nonNegativeInteger" },
+        "ws_send_queue_max":    { "$ref": "#/definitions/nonNegativeInteger" },
+        "ws_send_queue_policy": { "type": "string", "enum": ["disconnect", "drop_oldest"] },
+
         "logging_limit":           { "$ref": "#/definitions/positiveInteger" },
         "logging_paging_default":  { "$ref": "#/definitions/positiveInteger" },
         "logging_paging_limit":    { "$ref": "#/definitions/positiveInteger" },
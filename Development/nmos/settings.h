@@ -172,6 +172,10 @@ namespace nmos
         const web::json::field_as_integer_or discovery_backoff_max{ U("discovery_backoff_max"), 30 };
         const web::json::field_with_default<double> discovery_backoff_factor{ U("discovery_backoff_factor"), 1.5 };
 
+        // discovery_cache_interval [registry, node]: interval in seconds between the background refreshes of the cache of discovered service instances,
+        // from which later discovery of e.g. Registration APIs, System APIs or Authorization APIs is answered immediately; zero (the default) disables the cache
+        const web::json::field_as_integer_or discovery_cache_interval{ U("discovery_cache_interval"), 0 };
+
         // service_name_prefix [registry, node]: used as a prefix in the advertised service names ("<prefix>_<api>_<host>:<port>", e.g. "nmos-cpp_node_127-0-0-1:3212")
         const web::json::field_as_string_or service_name_prefix{ U("service_name_prefix"), U("nmos-cpp") };
 
@@ -290,6 +294,17 @@ namespace nmos
             // allow_invalid_resources [registry]: boolean value, true (attempt to ignore schema validation errors and cope with out-of-order registrations) or false (default)
             const web::json::field_as_bool_or allow_invalid_resources{ U("allow_invalid_resources"), false };
 
+            // registration_batch_available [registry]: used to enable the experimental batch registration endpoint of the Registration API, which is advertised to Nodes
+            const web::json::field_as_bool_or registration_batch_available{ U("registration_batch_available"), false };
+
+            // registration_batch_max [node]: maximum number of resources to register in each request, when the Registration API advertises the experimental batch registration endpoint
+            // (the default value of 0, or a value of 1, disables the use of the batch registration endpoint, so no request is made to discover whether it is advertised)
+            const web::json::field_as_integer_or registration_batch_max{ U("registration_batch_max"), 0 };
+
+            // registration_request_window [node]: maximum number of concurrent requests to the Registration API /resource endpoint, for resources which do not depend on each other
+            // (the default value of 1 means that each request is made after the previous response has been received)
+            const web::json::field_as_integer_or registration_request_window{ U("registration_request_window"), 1 };
+
             // port numbers [registry, node]: ports to which clients should connect for each API
             // see http_port
 
@@ -328,6 +343,27 @@ namespace nmos
             const web::json::field_as_integer_or query_ws_paging_default{ U("query_ws_paging_default"), 10 };
             const web::json::field_as_integer_or query_ws_paging_limit{ U("query_ws_paging_limit"), 100 };
 
+            // representation_cache_max [registry, node]: maximum number of serialized resource representations cached by the Query API and Node API, for reuse while each resource is unchanged
+            // (when the cache is full, the least recently used representation is dropped, so this should be at least the number of resources multiplied by the number of API versions requested;
+            // a value of 0 disables the cache)
+            const web::json::field_as_integer_or representation_cache_max{ U("representation_cache_max"), 65536 };
+
+            // ws_listener_threads [registry, node]: number of threads used by each WebSocket API listener, e.g. to write messages to the connections
+            const web::json::field_as_integer_or ws_listener_threads{ U("ws_listener_threads"), 1 };
+
+            // ws_send_buffer_max [registry, node]: number of bytes a WebSocket API connection may have waiting to be written, above which further messages are queued
+            // (the default value of 0 means that messages are never queued)
+            const web::json::field_as_integer_or ws_send_buffer_max{ U("ws_send_buffer_max"), 0 };
+
+            // ws_send_queue_max [registry, node]: maximum number of messages queued for a WebSocket API connection, above which ws_send_queue_policy is applied
+            // (the default value of 0 means there is no limit)
+            const web::json::field_as_integer_or ws_send_queue_max{ U("ws_send_queue_max"), 0 };
+
+            // ws_send_queue_policy [registry, node]: what to do when a message is sent to a WebSocket API connection whose send queue is full
+            // "disconnect" (default): close the connection, since the client isn't keeping up; the client can reconnect, and e.g. the Query WebSocket API then sends a 'sync' message
+            // "drop_oldest": drop the oldest queued message
+            const web::json::field_as_string_or ws_send_queue_policy{ U("ws_send_queue_policy"), U("disconnect") };
+
             // logging_limit [registry, node]: maximum number of log events cached for the Logging API
             const web::json::field_as_integer_or logging_limit{ U("logging_limit"), 1234 };
 
@@ -0,0 +1,116 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/activation_schedule.h"
+
+#include "bst/test/test.h"
+#include "nmos/activation_mode.h"
+#include "nmos/is05_versions.h"
+#include "nmos/json_fields.h"
+#include "nmos/resources.h"
+#include "nmos/slog.h"
+#include "nmos/version.h"
+
+namespace
+{
+    class test_gate : public slog::base_gate
+    {
+    public:
+        bool pertinent(slog::severity level) const override { return false; }
+        void log(const slog::log_message& message) const override {}
+    };
+
+    web::json::value make_test_activation(const nmos::activation_mode& mode, const web::json::value& requested_time, const web::json::value& activation_time)
+    {
+        using web::json::value_of;
+
+        return value_of({
+            { nmos::fields::mode, web::json::value::string(mode.name) },
+            { nmos::fields::requested_time, requested_time },
+            { nmos::fields::activation_time, activation_time }
+        });
+    }
+
+    nmos::resource make_test_sender(const nmos::id& id, const web::json::value& activation)
+    {
+        using web::json::value_of;
+
+        return{ nmos::is05_versions::v1_1, nmos::types::sender, value_of({
+            { U("id"), id },
+            { U("device_id"), U("these are not the droids you are looking for") },
+            { nmos::fields::endpoint_staged, value_of({
+                { nmos::fields::activation, activation }
+            }) }
+        }), false };
+    }
+
+    void set_test_activation(nmos::resources& resources, const nmos::id& id, const web::json::value& activation)
+    {
+        nmos::modify_resource(resources, id, [&](nmos::resource& resource)
+        {
+            resource.data[nmos::fields::endpoint_staged][nmos::fields::activation] = activation;
+        });
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testActivationSchedule)
+{
+    using web::json::value;
+    using web::json::value_of;
+
+    test_gate gate;
+    nmos::resources resources;
+    nmos::details::activation_schedule schedule;
+
+    const auto now = nmos::tai_clock::now();
+    const auto soon = now + bst::chrono::seconds(1);
+    const auto later = now + bst::chrono::seconds(2);
+    const auto version = [](const nmos::tai_clock::time_point& tp) { return value::string(nmos::make_version(nmos::tai_from_time_point(tp))); };
+
+    const auto not_pending = value_of({ { nmos::fields::mode, value::null() }, { nmos::fields::requested_time, value::null() }, { nmos::fields::activation_time, value::null() } });
+
+    nmos::insert_resource(resources, make_test_sender(U("a"), make_test_activation(nmos::activation_modes::activate_scheduled_absolute, version(later), version(later))));
+    nmos::insert_resource(resources, make_test_sender(U("b"), make_test_activation(nmos::activation_modes::activate_scheduled_relative, value::string(U("1:0")), version(soon))));
+    nmos::insert_resource(resources, make_test_sender(U("c"), not_pending));
+
+    schedule.update(resources, gate);
+    BST_REQUIRE_EQUAL(2, schedule.size());
+    BST_REQUIRE(soon == schedule.next());
+    BST_REQUIRE(schedule.pop_due(now).empty());
+
+    // an immediate activation is due straight away
+    set_test_activation(resources, U("c"), make_test_activation(nmos::activation_modes::activate_immediate, version(now), value::null()));
+
+    schedule.update(resources, gate);
+    BST_REQUIRE_EQUAL(3, schedule.size());
+
+    auto due = schedule.pop_due(now);
+    BST_REQUIRE_EQUAL(1, due.size());
+    BST_REQUIRE_EQUAL(U("c"), due[0].id_type.first);
+    BST_REQUIRE(due[0].immediate);
+
+    // cancelling a scheduled activation unschedules it
+    set_test_activation(resources, U("b"), not_pending);
+
+    schedule.update(resources, gate);
+    BST_REQUIRE_EQUAL(1, schedule.size());
+    BST_REQUIRE(later == schedule.next());
+
+    // rescheduling replaces the previous activation time
+    set_test_activation(resources, U("a"), make_test_activation(nmos::activation_modes::activate_scheduled_absolute, version(soon), version(soon)));
+
+    schedule.update(resources, gate);
+    BST_REQUIRE_EQUAL(1, schedule.size());
+    BST_REQUIRE(soon == schedule.next());
+
+    due = schedule.pop_due(later);
+    BST_REQUIRE_EQUAL(1, due.size());
+    BST_REQUIRE_EQUAL(U("a"), due[0].id_type.first);
+    BST_REQUIRE(!due[0].immediate);
+
+    BST_REQUIRE(schedule.empty());
+    BST_REQUIRE((nmos::tai_clock::time_point::max)() == schedule.next());
+
+    // unmodified resources are not examined again, so an update with no changes schedules nothing
+    schedule.update(resources, gate);
+    BST_REQUIRE(schedule.empty());
+}
@@ -701,6 +701,81 @@ BST_TEST_CASE(testFindProperty)
     }
 }
 
+BST_TEST_CASE(testFindPropertyAndMethodInDerivedClass)
+{
+    using web::json::value;
+
+    // derived from NcWorker, and a further class derived from that
+    const auto derived_class_id = nmos::nc::make_class_id(nmos::nc_worker_class_id, 0, { 1 });
+    auto further_derived_class_id = derived_class_id;
+    further_derived_class_id.push_back(1);
+    const auto derived_property_id = nmos::nc_property_id(3, 1);
+    const auto derived_method_id = nmos::nc_method_id(3, 1);
+
+    nmos::experimental::control_protocol_state control_protocol_state;
+    auto get_control_protocol_class_descriptor = nmos::make_get_control_protocol_class_descriptor_handler(control_protocol_state);
+    auto get_control_protocol_method_descriptor = nmos::make_get_control_protocol_method_descriptor_handler(control_protocol_state);
+    auto get_control_protocol_property_descriptor = nmos::make_get_control_protocol_property_descriptor_handler(control_protocol_state);
+
+    {
+        // invalid - find derived property before the class has been inserted
+        auto property = nmos::nc::find_property_descriptor(derived_property_id, further_derived_class_id, get_control_protocol_class_descriptor);
+        BST_REQUIRE(property.is_null());
+    }
+
+    const auto derived_property = nmos::experimental::make_control_class_property_descriptor(U("Derived property"), derived_property_id, U("derivedProperty"), U("NcBoolean"));
+    const auto derived_method = nmos::experimental::make_control_class_method_descriptor(U("Derived method"), derived_method_id, U("DerivedMethod"), U("NcMethodResult"), {}, false,
+        [](nmos::resources&, const nmos::resource&, const value&, bool, slog::base_gate&) { return value::null(); });
+    BST_REQUIRE(control_protocol_state.insert(nmos::experimental::make_control_class_descriptor(U("Derived class"), derived_class_id, U("DerivedClass"), { derived_property }, { derived_method })));
+
+    {
+        // valid - find derived property in the derived class
+        auto property = nmos::nc::find_property_descriptor(derived_property_id, derived_class_id, get_control_protocol_class_descriptor);
+        BST_REQUIRE_EQUAL(derived_property, property);
+    }
+    {
+        // valid - find derived property in a further derived class which has not been inserted
+        auto property = nmos::nc::find_property_descriptor(derived_property_id, further_derived_class_id, get_control_protocol_class_descriptor);
+        BST_REQUIRE_EQUAL(derived_property, property);
+    }
+    {
+        // valid - find inherited NcWorker and NcObject properties in the derived class
+        BST_REQUIRE(!nmos::nc::find_property_descriptor(nmos::nc_worker_enabled_property_id, derived_class_id, get_control_protocol_class_descriptor).is_null());
+        BST_REQUIRE(!nmos::nc::find_property_descriptor(nmos::nc_object_role_property_id, derived_class_id, get_control_protocol_class_descriptor).is_null());
+    }
+    {
+        // valid - the property descriptor handler, which uses the control protocol state's descriptor index, agrees with the class hierarchy walk
+        for (const auto& property_id : { derived_property_id, nmos::nc_worker_enabled_property_id, nmos::nc_object_role_property_id, nmos::nc_property_id(4, 1) })
+        {
+            for (const auto& class_id : { derived_class_id, further_derived_class_id, nmos::nc_worker_class_id })
+            {
+                BST_REQUIRE_EQUAL(nmos::nc::find_property_descriptor(property_id, class_id, get_control_protocol_class_descriptor), get_control_protocol_property_descriptor(class_id, property_id));
+            }
+        }
+    }
+    {
+        // valid - find derived and inherited methods in the derived class
+        BST_REQUIRE_EQUAL(nmos::fields::nc::id(derived_method.first), nmos::fields::nc::id(get_control_protocol_method_descriptor(derived_class_id, derived_method_id).first));
+        BST_REQUIRE(!get_control_protocol_method_descriptor(further_derived_class_id, nmos::nc_object_get_method_id).first.is_null());
+    }
+    {
+        // invalid - find derived method in NcWorker
+        BST_REQUIRE(get_control_protocol_method_descriptor(nmos::nc_worker_class_id, derived_method_id).first.is_null());
+    }
+
+    BST_REQUIRE(control_protocol_state.erase(derived_class_id));
+
+    {
+        // invalid - find derived property and method after the class has been erased
+        BST_REQUIRE(nmos::nc::find_property_descriptor(derived_property_id, further_derived_class_id, get_control_protocol_class_descriptor).is_null());
+        BST_REQUIRE(get_control_protocol_method_descriptor(derived_class_id, derived_method_id).first.is_null());
+        BST_REQUIRE(get_control_protocol_property_descriptor(further_derived_class_id, derived_property_id).is_null());
+        // valid - inherited properties are still found
+        BST_REQUIRE(!nmos::nc::find_property_descriptor(nmos::nc_worker_enabled_property_id, further_derived_class_id, get_control_protocol_class_descriptor).is_null());
+        BST_REQUIRE(!get_control_protocol_property_descriptor(further_derived_class_id, nmos::nc_worker_enabled_property_id).is_null());
+    }
+}
+
 BST_TEST_CASE(testConstraints)
 {
     using web::json::value_of;
@@ -1,12 +1,14 @@
 // The first "test" is of course whether the header compiles standalone
 #include "boost/iostreams/stream.hpp"
 #include "boost/iostreams/device/null.hpp"
+#include <chrono>
 #include "nmos/control_protocol_behaviour.h"
 #include "nmos/control_protocol_resource.h"
 #include "nmos/control_protocol_resources.h"
 #include "nmos/control_protocol_state.h"
 #include "nmos/control_protocol_typedefs.h"
 #include "nmos/control_protocol_utils.h"
+#include "nmos/id.h"
 #include "nmos/is04_versions.h"
 #include "nmos/is12_versions.h"
 #include "nmos/log_gate.h"
@@ -1352,6 +1354,32 @@ BST_TEST_CASE(testSetMonitorStatusWithDelay)
     }
 }
 
+namespace
+{
+    // make a device model of the specified number of blocks in the root block, each with the specified number of receiver monitors,
+    // each of which has a touchpoint to the receiver with the corresponding id
+    nmos::control_protocol_resource make_test_device_model(size_t block_count, size_t monitor_count, const std::vector<nmos::id>& receiver_ids)
+    {
+        using web::json::value_of;
+
+        auto root_block = nmos::make_root_block();
+        nmos::nc_oid oid = nmos::root_block_oid;
+        for (size_t b = 0; b < block_count; ++b)
+        {
+            const auto block_oid = ++oid;
+            auto block = nmos::make_block(block_oid, nmos::root_block_oid, U("block") + utility::s2us(std::to_string(b)), U("block"), U("block"));
+            for (size_t m = 0; m < monitor_count; ++m)
+            {
+                const auto& receiver_id = receiver_ids[b * monitor_count + m];
+                auto monitor = nmos::make_receiver_monitor(++oid, true, block_oid, U("mon") + utility::s2us(std::to_string(m)), U("monitor"), U("monitor"), value_of({ { nmos::nc::details::make_touchpoint_nmos({ nmos::ncp_touchpoint_resource_types::receiver, receiver_id }) } }));
+                nmos::nc::push_back(block, monitor);
+            }
+            nmos::nc::push_back(root_block, block);
+        }
+        return root_block;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 BST_TEST_CASE(testFindTouchpointResources)
 {
@@ -1412,6 +1440,219 @@ BST_TEST_CASE(testFindTouchpointResources)
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testFindResourceByOidTouchpointAndRolePath)
+{
+    using web::json::value_of;
+
+    nmos::id_generator make_id;
+    std::vector<nmos::id> receiver_ids;
+    for (size_t i = 0; i < 4; ++i) receiver_ids.push_back(make_id());
+
+    // root: block0: mon0 (oid 3), mon1 (oid 4); block1: mon0 (oid 6), mon1 (oid 7)
+    auto root_block = make_test_device_model(2, 2, receiver_ids);
+
+    nmos::resources resources;
+    nmos::nc::insert_root(resources, root_block);
+
+    {
+        // find by oid
+        const auto found = nmos::nc::find_resource(resources, nmos::nc_oid(6));
+        BST_REQUIRE(resources.end() != found);
+        BST_CHECK_EQUAL(6, nmos::fields::nc::oid(found->data));
+        BST_CHECK(resources.end() == nmos::nc::find_resource(resources, nmos::nc_oid(1000)));
+    }
+    {
+        // find by touchpoint
+        const auto found = nmos::nc::find_resource(resources, nmos::types::nc_status_monitor, receiver_ids[3]);
+        BST_REQUIRE(resources.end() != found);
+        BST_CHECK_EQUAL(7, nmos::fields::nc::oid(found->data));
+        BST_CHECK(resources.end() == nmos::nc::find_resource(resources, nmos::types::nc_block, receiver_ids[3]));
+        BST_CHECK(resources.end() == nmos::nc::find_resource(resources, nmos::types::nc_status_monitor, make_id()));
+    }
+    {
+        // find by role path
+        const auto found = nmos::nc::find_resource_by_role_path(resources, value_of({ U("root"), U("block1"), U("mon0") }).as_array());
+        BST_REQUIRE(resources.end() != found);
+        BST_CHECK_EQUAL(6, nmos::fields::nc::oid(found->data));
+
+        const auto block = nmos::nc::find_resource_by_role_path(resources, U("root.block0"));
+        BST_REQUIRE(resources.end() != block);
+        BST_CHECK_EQUAL(2, nmos::fields::nc::oid(block->data));
+
+        const auto root = nmos::nc::find_resource_by_role_path(resources, value_of({ U("root") }).as_array());
+        BST_REQUIRE(resources.end() != root);
+        BST_CHECK_EQUAL(1, nmos::fields::nc::oid(root->data));
+
+        BST_CHECK(resources.end() == nmos::nc::find_resource_by_role_path(resources, value_of({ U("root"), U("block1"), U("mon2") }).as_array()));
+        BST_CHECK(resources.end() == nmos::nc::find_resource_by_role_path(resources, value_of({ U("block1"), U("mon0") }).as_array()));
+        BST_CHECK(resources.end() == nmos::nc::find_resource_by_role_path(resources, value_of({ U("root"), U("mon0") }).as_array()));
+    }
+
+    // erase an object, and then a block
+    BST_REQUIRE_EQUAL(nmos::resources::size_type(1), nmos::nc::erase_resource(resources, U("7")));
+    BST_CHECK(resources.end() == nmos::nc::find_resource(resources, nmos::nc_oid(7)));
+    BST_CHECK(resources.end() == nmos::nc::find_resource(resources, nmos::types::nc_status_monitor, receiver_ids[3]));
+    BST_CHECK(resources.end() == nmos::nc::find_resource_by_role_path(resources, U("root.block1.mon1")));
+    BST_CHECK(resources.end() != nmos::nc::find_resource_by_role_path(resources, U("root.block1.mon0")));
+
+    BST_REQUIRE_EQUAL(nmos::resources::size_type(1), nmos::nc::erase_resource(resources, U("5")));
+    BST_CHECK(resources.end() == nmos::nc::find_resource_by_role_path(resources, U("root.block1.mon0")));
+    BST_CHECK(resources.end() != nmos::nc::find_resource_by_role_path(resources, U("root.block0.mon1")));
+
+    // reinsert the object with a different role
+    auto monitor = nmos::make_receiver_monitor(7, true, 2, U("mon2"), U("monitor"), U("monitor"), value_of({ { nmos::nc::details::make_touchpoint_nmos({ nmos::ncp_touchpoint_resource_types::receiver, receiver_ids[3] }) } }));
+    BST_REQUIRE(nmos::nc::insert_resource(resources, std::move(monitor)).second);
+    BST_CHECK(resources.end() != nmos::nc::find_resource(resources, nmos::types::nc_status_monitor, receiver_ids[3]));
+    BST_CHECK(resources.end() != nmos::nc::find_resource_by_role_path(resources, U("root.block0.mon2")));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testFindResourceWithoutIndex)
+{
+    using web::json::value_of;
+
+    nmos::id_generator make_id;
+    std::vector<nmos::id> receiver_ids;
+    for (size_t i = 0; i < 4; ++i) receiver_ids.push_back(make_id());
+
+    auto root_block = make_test_device_model(2, 2, receiver_ids);
+
+    // a device model inserted without using nmos::nc::insert_resource is not indexed, but can still be searched
+    nmos::resources resources;
+    std::function<void(nmos::control_protocol_resource&)> insert_resources = [&](nmos::control_protocol_resource& resource)
+    {
+        for (auto& r : resource.resources) insert_resources(r);
+        insert_resource(resources, std::move(resource));
+    };
+    insert_resources(root_block);
+    BST_REQUIRE(resources.control_protocol_objects.objects.empty());
+
+    const auto found = nmos::nc::find_resource(resources, nmos::types::nc_status_monitor, receiver_ids[3]);
+    BST_REQUIRE(resources.end() != found);
+    BST_CHECK_EQUAL(7, nmos::fields::nc::oid(found->data));
+
+    const auto role_path_found = nmos::nc::find_resource_by_role_path(resources, U("root.block1.mon1"));
+    BST_REQUIRE(resources.end() != role_path_found);
+    BST_CHECK_EQUAL(7, nmos::fields::nc::oid(role_path_found->data));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testFindResourceIndexConsistency)
+{
+    using web::json::value_of;
+
+    const size_t block_count = 4;
+    const size_t monitor_count = 4;
+
+    nmos::id_generator make_id;
+    std::vector<nmos::id> receiver_ids;
+    for (size_t i = 0; i < block_count * monitor_count; ++i) receiver_ids.push_back(make_id());
+
+    // every role path in the device model, and some which aren't
+    std::vector<web::json::value> role_paths{ value_of({ U("root") }), value_of({ U("block0") }), value_of({ U("root"), U("mon0") }) };
+    for (size_t b = 0; b <= block_count; ++b)
+    {
+        const auto block = U("block") + utility::s2us(std::to_string(b));
+        role_paths.push_back(value_of({ U("root"), block }));
+        for (size_t m = 0; m <= monitor_count; ++m)
+        {
+            role_paths.push_back(value_of({ U("root"), block, U("mon") + utility::s2us(std::to_string(m)) }));
+        }
+    }
+
+    // root: block0 (oid 2): mon0 (oid 3)...mon3 (oid 6); block1 (oid 7): mon0 (oid 8)...mon3 (oid 11); etc.
+    auto indexed_root_block = make_test_device_model(block_count, monitor_count, receiver_ids);
+    nmos::resources indexed;
+    nmos::nc::insert_root(indexed, indexed_root_block);
+
+    // the same device model inserted without using nmos::nc::insert_resource is searched by linear scan
+    auto unindexed_root_block = make_test_device_model(block_count, monitor_count, receiver_ids);
+    nmos::resources unindexed;
+    std::function<void(nmos::control_protocol_resource&)> insert_resources = [&](nmos::control_protocol_resource& resource)
+    {
+        for (auto& r : resource.resources) insert_resources(r);
+        insert_resource(unindexed, std::move(resource));
+    };
+    insert_resources(unindexed_root_block);
+    BST_REQUIRE(unindexed.control_protocol_objects.objects.empty());
+
+    // the index has exactly one entry for each control protocol object, and its member and touchpoint entries
+    const auto check_index = [&]
+    {
+        const auto& index = indexed.control_protocol_objects;
+
+        size_t count = 0;
+        size_t members = 0;
+        size_t touchpoints = 0;
+        for (const auto& resource : indexed)
+        {
+            if (!resource.has_data() || !resource.data.has_field(nmos::fields::nc::oid)) continue;
+            ++count;
+
+            const auto found = index.objects.find(nmos::fields::nc::oid(resource.data));
+            BST_REQUIRE(index.objects.end() != found);
+            BST_REQUIRE_EQUAL(resource.id, found->second.id);
+            if (found->second.has_owner) ++members;
+            touchpoints += found->second.touchpoints.size();
+        }
+        BST_REQUIRE_EQUAL(count, index.objects.size());
+
+        size_t indexed_members = 0;
+        for (const auto& block : index.members) indexed_members += block.second.size();
+        BST_REQUIRE_EQUAL(members, indexed_members);
+        BST_REQUIRE_EQUAL(touchpoints, index.touchpoints.size());
+    };
+
+    // lookups by touchpoint and by role path using the index agree with the linear scan
+    const auto check_lookups = [&]
+    {
+        auto touchpoint_ids = receiver_ids;
+        touchpoint_ids.push_back(make_id());
+        for (const auto& receiver_id : touchpoint_ids)
+        {
+            const auto expected = nmos::nc::find_resource(unindexed, nmos::types::nc_status_monitor, receiver_id);
+            const auto found = nmos::nc::find_resource(indexed, nmos::types::nc_status_monitor, receiver_id);
+            BST_REQUIRE_EQUAL(unindexed.end() == expected, indexed.end() == found);
+            if (indexed.end() != found) BST_REQUIRE_EQUAL(expected->id, found->id);
+        }
+
+        for (const auto& role_path : role_paths)
+        {
+            const auto expected = nmos::nc::find_resource_by_role_path(unindexed, role_path.as_array());
+            const auto found = nmos::nc::find_resource_by_role_path(indexed, role_path.as_array());
+            BST_REQUIRE_EQUAL(unindexed.end() == expected, indexed.end() == found);
+            if (indexed.end() != found) BST_REQUIRE_EQUAL(expected->id, found->id);
+        }
+    };
+
+    BST_REQUIRE_EQUAL(unindexed.size(), indexed.size());
+    check_index();
+    check_lookups();
+
+    // erase an object, and then a block, whose members remain in the resources but can no longer be found by role path
+    for (const auto& id : std::vector<nmos::id>{ U("4"), U("7") })
+    {
+        BST_REQUIRE_EQUAL(nmos::resources::size_type(1), nmos::nc::erase_resource(indexed, id));
+        unindexed.erase(unindexed.find(id));
+
+        check_index();
+        check_lookups();
+    }
+
+    // reinsert the object
+    const auto make_monitor = [&]
+    {
+        return nmos::make_receiver_monitor(4, true, 2, U("mon1"), U("monitor"), U("monitor"), value_of({ { nmos::nc::details::make_touchpoint_nmos({ nmos::ncp_touchpoint_resource_types::receiver, receiver_ids[1] }) } }));
+    };
+    BST_REQUIRE(nmos::nc::insert_resource(indexed, make_monitor()).second);
+    BST_REQUIRE(insert_resource(unindexed, make_monitor()).second);
+
+    check_index();
+    check_lookups();
+    BST_REQUIRE(indexed.end() != nmos::nc::find_resource_by_role_path(indexed, U("root.block0.mon1")));
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 BST_TEST_CASE(testFindMembersByClassId)
 {
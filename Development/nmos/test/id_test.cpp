@@ -0,0 +1,42 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/id.h"
+
+#include "bst/test/test.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testParseUuid)
+{
+    nmos::uuid uuid;
+    BST_REQUIRE(nmos::parse_uuid(U("0123abcd-4567-89ef-0a1b-2c3d4e5f6789"), uuid));
+    BST_REQUIRE_EQUAL(0x0123abcd456789efULL, uuid.hi);
+    BST_REQUIRE_EQUAL(0x0a1b2c3d4e5f6789ULL, uuid.lo);
+    BST_REQUIRE_EQUAL(U("0123abcd-4567-89ef-0a1b-2c3d4e5f6789"), nmos::make_id(uuid));
+
+    // ids generated by nmos::make_id are in canonical form
+    nmos::id_generator make_id;
+    for (int i = 0; i < 100; ++i)
+    {
+        const auto id = make_id();
+        BST_REQUIRE(nmos::parse_uuid(id, uuid));
+        BST_REQUIRE_EQUAL(id, nmos::make_id(uuid));
+    }
+
+    // the ordering of UUIDs is the same as the ordering of their canonical string forms
+    nmos::uuid lhs, rhs;
+    BST_REQUIRE(nmos::parse_uuid(U("01234567-89ab-cdef-0123-456789abcdef"), lhs));
+    BST_REQUIRE(nmos::parse_uuid(U("01234567-89ab-cdf0-0000-000000000000"), rhs));
+    BST_REQUIRE(lhs < rhs);
+    BST_REQUIRE(!(rhs < lhs));
+    BST_REQUIRE(lhs != rhs);
+
+    // other ids are rejected, and the result is unchanged
+    const nmos::uuid unchanged = uuid;
+    BST_REQUIRE(!nmos::parse_uuid(U(""), uuid));
+    BST_REQUIRE(!nmos::parse_uuid(U("a"), uuid));
+    BST_REQUIRE(!nmos::parse_uuid(U("0123ABCD-4567-89ef-0a1b-2c3d4e5f6789"), uuid));
+    BST_REQUIRE(!nmos::parse_uuid(U("0123abcd-4567-89ef-0a1b-2c3d4e5f678g"), uuid));
+    BST_REQUIRE(!nmos::parse_uuid(U("0123abcd-4567-89ef-0a1b-2c3d4e5f67890"), uuid));
+    BST_REQUIRE(!nmos::parse_uuid(U("0123abcd+4567-89ef-0a1b-2c3d4e5f6789"), uuid));
+    BST_REQUIRE(!nmos::parse_uuid(U("{0123abcd-4567-89ef-0a1b-2c3d4e5f678}"), uuid));
+    BST_REQUIRE(unchanged == uuid);
+}
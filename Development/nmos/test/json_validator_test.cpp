@@ -4,6 +4,12 @@
 #include "bst/test/test.h"
 #include "cpprest/basic_utils.h" // for utility::us2s, utility::s2us
 #include "cpprest/json_utils.h"
+#include "cpprest/json_validator_impl.h"
+#include "detail/pragma_warnings.h"
+PRAGMA_WARNING_PUSH
+PRAGMA_WARNING_DISABLE_CONDITIONAL_EXPRESSION_IS_CONSTANT
+#include "nlohmann/json.hpp"
+PRAGMA_WARNING_POP
 
 namespace
 {
@@ -86,3 +92,125 @@ BST_TEST_CASE(testEnumSchema)
     validator.validate(value_of({ { U("foo"), U("good") } }), id);
     BST_REQUIRE(true);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testToBasicJson)
+{
+    using web::json::value_of;
+
+    const auto value = value_of({
+        { U("null"), web::json::value::null() },
+        { U("bool"), true },
+        { U("unsigned"), 42 },
+        { U("negative"), -42 },
+        { U("large"), uint64_t(18446744073709551615u) },
+        { U("double"), 0.5 },
+        { U("string"), U("foo") },
+        { U("array"), value_of({ U("bar"), 1, value_of({ { U("baz"), web::json::value::array() } }) }) },
+        { U("object"), web::json::value::object() }
+    });
+
+    const auto expected = nlohmann::json::parse(utility::us2s(value.serialize()));
+    const auto actual = web::json::experimental::details::to_basic_json<nlohmann::json>(value);
+    BST_REQUIRE(expected == actual);
+    BST_REQUIRE(actual["unsigned"].is_number_unsigned());
+    BST_REQUIRE(actual["negative"].is_number_integer() && !actual["negative"].is_number_unsigned());
+    BST_REQUIRE(actual["double"].is_number_float());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// The direct tree conversion of typical IS-04 resources to the validator's instance type is equivalent to serializing and parsing
+BST_TEST_CASE(testToBasicJsonResources)
+{
+    using web::json::value_of;
+
+    // based on the IS-04 v1.3 node, device, sender and flow examples
+    const std::vector<web::json::value> resources
+    {
+        value_of({
+            { U("id"), U("3b8be755-08ff-452b-b217-c9151eb21193") },
+            { U("version"), U("1441973902:879053935") },
+            { U("label"), U("host1") },
+            { U("description"), U("host1") },
+            { U("tags"), web::json::value::object() },
+            { U("href"), U("http://172.29.80.65:12345/") },
+            { U("hostname"), U("host1") },
+            { U("api"), value_of({
+                { U("versions"), value_of({ U("v1.0"), U("v1.1"), U("v1.2"), U("v1.3") }) },
+                { U("endpoints"), value_of({
+                    value_of({ { U("host"), U("172.29.80.65") }, { U("port"), 12345 }, { U("protocol"), U("http") } }),
+                    value_of({ { U("host"), U("host1.example.com") }, { U("port"), 443 }, { U("protocol"), U("https") }, { U("authorization"), true } })
+                }) }
+            }) },
+            { U("caps"), web::json::value::object() },
+            { U("services"), value_of({
+                value_of({ { U("href"), U("http://172.29.80.65:12345/x-manufacturer/pipelinemanager/") }, { U("type"), U("urn:x-manufacturer:service:pipelinemanager") }, { U("authorization"), false } })
+            }) },
+            { U("clocks"), value_of({
+                value_of({ { U("name"), U("clk0") }, { U("ref_type"), U("internal") } }),
+                value_of({ { U("name"), U("clk1") }, { U("ref_type"), U("ptp") }, { U("version"), U("IEEE1588-2008") }, { U("gmid"), U("08-00-11-ff-fe-21-e1-b0") }, { U("traceable"), false }, { U("locked"), true } })
+            }) },
+            { U("interfaces"), value_of({
+                value_of({ { U("chassis_id"), U("00-15-5d-67-c3-4e") }, { U("port_id"), U("00-15-5d-67-c3-4e") }, { U("name"), U("eth0") } }),
+                value_of({ { U("chassis_id"), U("96fa9f6c-f3f0-4a3b-8f4d-4ec5d3d8c4c5") }, { U("port_id"), U("00-15-5d-67-c3-5e") }, { U("name"), U("eth1") } })
+            }) }
+        }),
+        value_of({
+            { U("id"), U("58f6b536-ca4c-43fd-880d-87f3de8a2b8b") },
+            { U("version"), U("1441704616:587121295") },
+            { U("label"), U("Encoder Device") },
+            { U("description"), U("Encoder Device") },
+            { U("tags"), web::json::value::object() },
+            { U("type"), U("urn:x-nmos:device:pipeline") },
+            { U("node_id"), U("3b8be755-08ff-452b-b217-c9151eb21193") },
+            { U("senders"), web::json::value::array() },
+            { U("receivers"), web::json::value::array() },
+            { U("controls"), value_of({
+                value_of({ { U("href"), U("wss://154.67.63.2:4535") }, { U("type"), U("urn:x-manufacturer:control:generic") }, { U("authorization"), false } })
+            }) }
+        }),
+        value_of({
+            { U("id"), U("d7aa5a30-681d-4e72-92fb-f0ba0f6f4c3e") },
+            { U("version"), U("1441704616:890020555") },
+            { U("label"), U("Example Sender") },
+            { U("description"), U("Example Sender") },
+            { U("tags"), web::json::value::object() },
+            { U("flow_id"), U("5fbec3b1-1b0f-417d-9059-8b94a47197ed") },
+            { U("transport"), U("urn:x-nmos:transport:rtp.mcast") },
+            { U("device_id"), U("58f6b536-ca4c-43fd-880d-87f3de8a2b8b") },
+            { U("manifest_href"), U("http://172.29.80.65/x-nmos/connection/v1.0/single/senders/d7aa5a30-681d-4e72-92fb-f0ba0f6f4c3e/transportfile/") },
+            { U("interface_bindings"), value_of({ U("eth0"), U("eth1") }) },
+            { U("subscription"), value_of({ { U("receiver_id"), web::json::value::null() }, { U("active"), false } }) }
+        }),
+        value_of({
+            { U("id"), U("5fbec3b1-1b0f-417d-9059-8b94a47197ed") },
+            { U("version"), U("1441704616:890020555") },
+            { U("label"), U("Example Flow") },
+            { U("description"), U("Example Flow") },
+            { U("tags"), web::json::value::object() },
+            { U("format"), U("urn:x-nmos:format:video") },
+            { U("source_id"), U("2aa143ac-0ab7-4d75-bc32-5c00c13d186f") },
+            { U("device_id"), U("58f6b536-ca4c-43fd-880d-87f3de8a2b8b") },
+            { U("parents"), web::json::value::array() },
+            { U("grain_rate"), value_of({ { U("numerator"), 25 }, { U("denominator"), 1 } }) },
+            { U("media_type"), U("video/raw") },
+            { U("frame_width"), 1920 },
+            { U("frame_height"), 1080 },
+            { U("interlace_mode"), U("interlaced_tff") },
+            { U("colorspace"), U("BT709") },
+            { U("transfer_characteristic"), U("SDR") },
+            { U("components"), value_of({
+                value_of({ { U("name"), U("Y") }, { U("width"), 1920 }, { U("height"), 1080 }, { U("bit_depth"), 10 } }),
+                value_of({ { U("name"), U("Cb") }, { U("width"), 960 }, { U("height"), 1080 }, { U("bit_depth"), 10 } }),
+                value_of({ { U("name"), U("Cr") }, { U("width"), 960 }, { U("height"), 1080 }, { U("bit_depth"), 10 } })
+            }) }
+        })
+    };
+
+    for (const auto& resource : resources)
+    {
+        const auto expected = nlohmann::json::parse(utility::us2s(resource.serialize()));
+        const auto actual = web::json::experimental::details::to_basic_json<nlohmann::json>(resource);
+        BST_REQUIRE(expected == actual);
+    }
+}
@@ -1,9 +1,11 @@
 // The first "test" is of course whether the header compiles standalone
 #include "nmos/jwt_validator.h"
 
+#include <thread>
 #include <boost/range/join.hpp>
 #include <cpprest/http_msg.h>
 #include <jwt-cpp/jwt.h>
+#include <jwt-cpp/traits/nlohmann-json/traits.h>
 #include "bst/test/test.h"
 #include "cpprest/basic_utils.h" // for utility::us2s, utility::s2us
 #include "cpprest/json_utils.h"
@@ -341,3 +343,66 @@ BST_TEST_CASE(testAccessTokenPrivateClaim2)
     BST_REQUIRE_THROW(nmos::experimental::jwt_validator::registered_claims_validation(invalid_token1, web::http::methods::POST, U("/x-nmos/registration/v1.3/health/nodes/88888888-4444-4444-4444-cccccccccccc"), nmos::experimental::scopes::registration, audience), nmos::experimental::insufficient_scope_exception);
     BST_REQUIRE_THROW(nmos::experimental::jwt_validator::registered_claims_validation(invalid_token2, web::http::methods::POST, U("/x-nmos/registration/v1.3/health/nodes/88888888-4444-4444-4444-cccccccccccc"), nmos::experimental::scopes::registration, audience), nmos::experimental::insufficient_scope_exception);
 }
+
+namespace
+{
+    // create an access token signed by the test private key, with the specified key id (kid) in its header if not empty
+    utility::string_t make_test_token(const std::string& kid, const std::chrono::seconds& expires_in)
+    {
+        using jwt::traits::nlohmann_json;
+
+        const auto now = jwt::default_clock{}.now();
+        auto builder = jwt::create<nlohmann_json>()
+            .set_type("JWT")
+            .set_issuer("https://nmos-mocks.local:5011")
+            .set_subject("test@testsuite.nmos.tv")
+            .set_payload_claim("aud", nlohmann_json::value_type::array({ "https://*.testsuite.nmos.tv", "https://*.local" }))
+            .set_issued_at(now)
+            .set_expires_at(now + expires_in)
+            .set_payload_claim("scope", nlohmann_json::value_type("registration"))
+            .set_payload_claim("client_id", nlohmann_json::value_type("458f6d06-46b1-49fd-b778-7c30428889c6"))
+            .set_payload_claim("x-nmos-registration", nlohmann_json::value_type{ { "read", { "*" } }, { "write", { "*" } } });
+        if (!kid.empty()) builder.set_key_id(kid);
+        return utility::s2us(builder.sign(jwt::algorithm::rs512("", utility::us2s(test_private_key))));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testAccessTokenKeyId)
+{
+    // token kid matches the kid of the public key
+    const auto matching_kid_token = make_test_token(utility::us2s(key_id), std::chrono::hours(1));
+    BST_REQUIRE_NO_THROW(jwt_validator.basic_validation(matching_kid_token));
+    // and again, now that it has been verified
+    BST_REQUIRE_NO_THROW(jwt_validator.basic_validation(matching_kid_token));
+
+    // token without kid is tried against all the public keys
+    const auto missing_kid_token = make_test_token({}, std::chrono::hours(1));
+    BST_REQUIRE_NO_THROW(jwt_validator.basic_validation(missing_kid_token));
+
+    // token kid doesn't match any public key, so the public keys need to be re-fetched
+    const auto unknown_kid_token = make_test_token("unknown_key", std::chrono::hours(1));
+    BST_REQUIRE_THROW(jwt_validator.basic_validation(unknown_kid_token), nmos::experimental::no_matching_keys_exception);
+
+    // a public key without kid is tried for any token
+    auto unkeyed_jwk = jwk1;
+    unkeyed_jwk.erase(U("kid"));
+    const nmos::experimental::jwt_validator unkeyed_jwt_validator(value_of({
+        value_of({
+            { U("jwk"), unkeyed_jwk },
+            { U("pem"), test_public_key }
+        })
+    }), [](const web::json::value&) {});
+    BST_REQUIRE_NO_THROW(unkeyed_jwt_validator.basic_validation(unknown_kid_token));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testAccessTokenVerifiedExpiry)
+{
+    // a verified token must still be rejected once it has expired
+    const auto token = make_test_token(utility::us2s(key_id), std::chrono::seconds(1));
+    BST_REQUIRE_NO_THROW(jwt_validator.basic_validation(token));
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    BST_REQUIRE_THROW(jwt_validator.basic_validation(token), jwt::error::token_verification_exception);
+}
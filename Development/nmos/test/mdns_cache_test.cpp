@@ -0,0 +1,257 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/mdns_cache.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include "bst/test/test.h"
+#include "mdns/service_discovery_impl.h"
+#include "slog/all_in_one.h"
+
+namespace
+{
+    class test_gate : public slog::base_gate
+    {
+    public:
+        bool pertinent(slog::severity level) const override { return false; }
+        void log(const slog::log_message& message) const override {}
+    };
+
+    // the service instances which the test discovery implementation will find
+    struct test_services
+    {
+        std::mutex mutex;
+        std::vector<mdns::browse_result> browsed;
+        std::map<std::string, mdns::resolve_result> resolved;
+        int browse_count = 0;
+        int resolve_count = 0;
+    };
+
+    class test_discovery_impl : public mdns::details::service_discovery_impl
+    {
+    public:
+        explicit test_discovery_impl(test_services& services)
+            : services(services)
+        {}
+
+        pplx::task<bool> browse(const mdns::browse_handler& handler, const std::string& type, const std::string& domain, std::uint32_t interface_id, const std::chrono::steady_clock::duration& timeout, const pplx::cancellation_token& token) override
+        {
+            std::vector<mdns::browse_result> browsed;
+            {
+                std::lock_guard<std::mutex> lock(services.mutex);
+                ++services.browse_count;
+                browsed = services.browsed;
+            }
+            return pplx::create_task([handler, browsed]
+            {
+                bool had_enough = false;
+                for (const auto& result : browsed) had_enough = handler(result);
+                return had_enough;
+            });
+        }
+        pplx::task<bool> resolve(const mdns::resolve_handler& handler, const std::string& name, const std::string& type, const std::string& domain, std::uint32_t interface_id, const std::chrono::steady_clock::duration& timeout, const pplx::cancellation_token& token) override
+        {
+            std::vector<mdns::resolve_result> resolved;
+            {
+                std::lock_guard<std::mutex> lock(services.mutex);
+                ++services.resolve_count;
+                auto found = services.resolved.find(name);
+                if (services.resolved.end() != found) resolved.push_back(found->second);
+            }
+            return pplx::create_task([handler, resolved]
+            {
+                bool had_enough = false;
+                for (const auto& result : resolved) had_enough = handler(result);
+                return had_enough;
+            });
+        }
+        pplx::task<bool> getaddrinfo(const mdns::address_handler& handler, const std::string& host_name, std::uint32_t interface_id, const std::chrono::steady_clock::duration& timeout, const pplx::cancellation_token& token) override
+        {
+            return pplx::task_from_result(false);
+        }
+
+    private:
+        test_services& services;
+    };
+
+    // record the changes notified by the service discovery cache
+    struct test_changes
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<std::pair<nmos::experimental::service_instance_change, std::string>> changes;
+
+        nmos::experimental::service_instance_change_handler handler()
+        {
+            return [this](nmos::experimental::service_instance_change change, const mdns::browse_result& instance, const std::vector<mdns::resolve_result>&)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                changes.push_back({ change, instance.name });
+                condition.notify_all();
+            };
+        }
+
+        bool wait_for(size_t count)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            return condition.wait_for(lock, std::chrono::seconds(5), [&] { return changes.size() >= count; });
+        }
+    };
+
+    const std::string test_type{ "_nmos-register._tcp" };
+
+    mdns::browse_result make_test_browse_result(const std::string& name)
+    {
+        return{ name, test_type + ".", "local." };
+    }
+
+    mdns::resolve_result make_test_resolve_result(const std::string& host_name, std::uint16_t port, const std::string& pri)
+    {
+        mdns::resolve_result result{ host_name, port, { "api_proto=http", "api_ver=v1.3", "pri=" + pri } };
+        result.ip_addresses.push_back("192.0.2.1");
+        return result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testServiceDiscoveryCacheLookups)
+{
+    test_gate gate;
+    test_services services;
+    services.browsed.push_back(make_test_browse_result("registry1"));
+    services.resolved["registry1"] = make_test_resolve_result("registry1.local.", 3210, "10");
+
+    test_changes changes;
+    {
+        // a long refresh interval, so the only refresh is the first one
+        auto discovery = nmos::experimental::make_service_discovery_cache(mdns::service_discovery(std::unique_ptr<mdns::details::service_discovery_impl>(new test_discovery_impl(services))), std::chrono::hours(1), changes.handler(), gate);
+
+        // the first browse is passed through, and starts the background refresh
+        auto browsed = discovery.browse(test_type, "local.").get();
+        BST_REQUIRE_EQUAL(1, browsed.size());
+        BST_REQUIRE_EQUAL("registry1", browsed[0].name);
+
+        BST_REQUIRE(changes.wait_for(1));
+        BST_REQUIRE_EQUAL(nmos::experimental::service_instance_added, changes.changes[0].first);
+        BST_REQUIRE_EQUAL("registry1", changes.changes[0].second);
+
+        int browse_count = 0, resolve_count = 0;
+        {
+            std::lock_guard<std::mutex> lock(services.mutex);
+            browse_count = services.browse_count;
+            resolve_count = services.resolve_count;
+        }
+        BST_REQUIRE_EQUAL(2, browse_count);
+        BST_REQUIRE_EQUAL(1, resolve_count);
+
+        // subsequent lookups are answered from the cache
+        browsed = discovery.browse(test_type, "local.").get();
+        BST_REQUIRE_EQUAL(1, browsed.size());
+        BST_REQUIRE_EQUAL("registry1", browsed[0].name);
+
+        auto resolved = discovery.resolve(browsed[0].name, browsed[0].type, browsed[0].domain, browsed[0].interface_id).get();
+        BST_REQUIRE_EQUAL(1, resolved.size());
+        BST_REQUIRE_EQUAL(3210, resolved[0].port);
+        BST_REQUIRE_EQUAL(1, resolved[0].ip_addresses.size());
+
+        {
+            std::lock_guard<std::mutex> lock(services.mutex);
+            BST_REQUIRE_EQUAL(browse_count, services.browse_count);
+            BST_REQUIRE_EQUAL(resolve_count, services.resolve_count);
+        }
+
+        // other service types and domains are passed through
+        discovery.browse(test_type, "example.com.").wait();
+        {
+            std::lock_guard<std::mutex> lock(services.mutex);
+            BST_REQUIRE_LE(browse_count + 1, services.browse_count);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testServiceDiscoveryCacheChanges)
+{
+    test_gate gate;
+    test_services services;
+    services.browsed.push_back(make_test_browse_result("registry1"));
+    services.resolved["registry1"] = make_test_resolve_result("registry1.local.", 3210, "10");
+
+    test_changes changes;
+    {
+        auto discovery = nmos::experimental::make_service_discovery_cache(mdns::service_discovery(std::unique_ptr<mdns::details::service_discovery_impl>(new test_discovery_impl(services))), std::chrono::milliseconds(10), changes.handler(), gate);
+
+        discovery.browse(test_type, "local.").wait();
+        BST_REQUIRE(changes.wait_for(1));
+
+        // a new instance
+        {
+            std::lock_guard<std::mutex> lock(services.mutex);
+            services.browsed.push_back(make_test_browse_result("registry2"));
+            services.resolved["registry2"] = make_test_resolve_result("registry2.local.", 3210, "20");
+        }
+        BST_REQUIRE(changes.wait_for(2));
+        BST_REQUIRE_EQUAL(nmos::experimental::service_instance_added, changes.changes[1].first);
+        BST_REQUIRE_EQUAL("registry2", changes.changes[1].second);
+
+        // a changed TXT record
+        {
+            std::lock_guard<std::mutex> lock(services.mutex);
+            services.resolved["registry1"] = make_test_resolve_result("registry1.local.", 3210, "0");
+        }
+        BST_REQUIRE(changes.wait_for(3));
+        BST_REQUIRE_EQUAL(nmos::experimental::service_instance_updated, changes.changes[2].first);
+        BST_REQUIRE_EQUAL("registry1", changes.changes[2].second);
+
+        // a removed instance
+        {
+            std::lock_guard<std::mutex> lock(services.mutex);
+            services.browsed.erase(services.browsed.begin());
+        }
+        BST_REQUIRE(changes.wait_for(4));
+        BST_REQUIRE_EQUAL(nmos::experimental::service_instance_removed, changes.changes[3].first);
+        BST_REQUIRE_EQUAL("registry1", changes.changes[3].second);
+
+        const auto browsed = discovery.browse(test_type, "local.").get();
+        BST_REQUIRE_EQUAL(1, browsed.size());
+        BST_REQUIRE_EQUAL("registry2", browsed[0].name);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testServiceDiscoveryCacheHadEnough)
+{
+    test_gate gate;
+    test_services services;
+    services.browsed.push_back(make_test_browse_result("registry1"));
+    services.browsed.push_back(make_test_browse_result("registry2"));
+    services.resolved["registry1"] = make_test_resolve_result("registry1.local.", 3210, "10");
+    services.resolved["registry2"] = make_test_resolve_result("registry2.local.", 3210, "20");
+
+    test_changes changes;
+    {
+        auto discovery = nmos::experimental::make_service_discovery_cache(mdns::service_discovery(std::unique_ptr<mdns::details::service_discovery_impl>(new test_discovery_impl(services))), std::chrono::hours(1), changes.handler(), gate);
+
+        discovery.browse(test_type, "local.").wait();
+        BST_REQUIRE(changes.wait_for(2));
+
+        // a browse answered from the cache stops as soon as the handler has had enough
+        std::vector<std::string> names;
+        const bool had_enough = discovery.browse([&](const mdns::browse_result& instance)
+        {
+            names.push_back(instance.name);
+            return true;
+        }, test_type, "local.").get();
+        BST_REQUIRE(had_enough);
+        BST_REQUIRE_EQUAL(1, names.size());
+
+        // whereas one which never has enough sees every instance
+        names.clear();
+        BST_REQUIRE(!discovery.browse([&](const mdns::browse_result& instance)
+        {
+            names.push_back(instance.name);
+            return false;
+        }, test_type, "local.").get());
+        BST_REQUIRE_EQUAL(2, names.size());
+    }
+}
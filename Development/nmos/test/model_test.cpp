@@ -0,0 +1,113 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/model.h"
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include "bst/test/test.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testChangeChannelEpochs)
+{
+    nmos::node_model model;
+
+    // notifying a change channel only affects that channel
+    model.notify(model.events_changes);
+    BST_REQUIRE_EQUAL(1u, model.events_changes.epoch.load());
+    BST_REQUIRE_EQUAL(0u, model.connection_changes.epoch.load());
+    BST_REQUIRE_EQUAL(0u, model.channelmapping_changes.epoch.load());
+    BST_REQUIRE_EQUAL(0u, model.control_protocol_changes.epoch.load());
+
+    // whereas notifying the model as a whole also notifies every change channel
+    model.notify();
+    BST_REQUIRE_EQUAL(2u, model.events_changes.epoch.load());
+    BST_REQUIRE_EQUAL(1u, model.connection_changes.epoch.load());
+    BST_REQUIRE_EQUAL(1u, model.channelmapping_changes.epoch.load());
+    BST_REQUIRE_EQUAL(1u, model.control_protocol_changes.epoch.load());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testChangeChannelWakeups)
+{
+    nmos::node_model model;
+
+    bool waiting = false;
+    bool done = false;
+
+    std::thread waiter([&]
+    {
+        auto lock = model.write_lock();
+        model.wait(model.events_changes, lock, [&] { waiting = true; return done; });
+    });
+
+    // wait for the waiter to be blocked on the change channel
+    const auto wait_for = [&](std::function<bool()> pred)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            {
+                auto lock = model.write_lock();
+                if (pred()) return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    };
+    BST_REQUIRE(wait_for([&] { return waiting; }));
+
+    // notifying another change channel doesn't wake the waiter
+    model.notify(model.connection_changes);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BST_REQUIRE_EQUAL(0u, model.events_changes.wakeups.wakeups.load());
+
+    // notifying the change channel when nothing has changed is a spurious wakeup
+    model.notify(model.events_changes);
+    BST_REQUIRE(wait_for([&] { return 1u == model.events_changes.wakeups.wakeups.load(); }));
+    BST_REQUIRE_EQUAL(1u, model.events_changes.wakeups.spurious_wakeups.load());
+
+    {
+        auto lock = model.write_lock();
+        done = true;
+    }
+    model.notify(model.events_changes);
+    waiter.join();
+
+    BST_REQUIRE_EQUAL(2u, model.events_changes.wakeups.wakeups.load());
+    BST_REQUIRE_EQUAL(1u, model.events_changes.wakeups.spurious_wakeups.load());
+    BST_REQUIRE_EQUAL(0u, model.wakeups.wakeups.load());
+
+    // the one completed wait had one spurious wakeup
+    for (std::size_t n = 0; n < nmos::wakeup_counters::histogram_size; ++n)
+    {
+        BST_REQUIRE_EQUAL(1 == n ? 1u : 0u, model.events_changes.wakeups.spurious_wakeups_per_wait[n].load());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testSpuriousWakeupsHistogram)
+{
+    nmos::node_model model;
+
+    // a wait that is satisfied immediately has no spurious wakeups
+    {
+        auto lock = model.write_lock();
+        model.wait(model.control_protocol_changes, lock, [] { return true; });
+    }
+    BST_REQUIRE_EQUAL(1u, model.control_protocol_changes.wakeups.spurious_wakeups_per_wait[0].load());
+    BST_REQUIRE_EQUAL(0u, model.control_protocol_changes.wakeups.wakeups.load());
+
+    // a wait that times out without being woken doesn't count any spurious wakeups either
+    {
+        auto lock = model.write_lock();
+        BST_REQUIRE(!model.wait_until(model.control_protocol_changes, lock, nmos::tai_clock::now() + bst::chrono::milliseconds(10), [] { return false; }));
+    }
+    BST_REQUIRE_EQUAL(2u, model.control_protocol_changes.wakeups.spurious_wakeups_per_wait[0].load());
+
+    // and the model's own condition has its own histogram
+    {
+        auto lock = model.write_lock();
+        model.wait(lock, [] { return true; });
+    }
+    BST_REQUIRE_EQUAL(1u, model.wakeups.spurious_wakeups_per_wait[0].load());
+    BST_REQUIRE_EQUAL(2u, model.control_protocol_changes.wakeups.spurious_wakeups_per_wait[0].load());
+}
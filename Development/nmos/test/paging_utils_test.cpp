@@ -701,3 +701,83 @@ BST_TEST_CASE(testCursorBasedPagingUsingIndicesAsPoorCursors)
         BST_REQUIRE_EQUAL(10000, cursors.second);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEvaluatedCursorBasedPage)
+{
+    const resources resources{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+
+    const std::vector<std::function<bool(const resource&)>> predicates
+    {
+        [](const resource&) { return true; },
+        [](const resource&) { return false; },
+        [](const resource& r) { return 0 == r.cursor % 3; },
+        [](const resource& r) { return 7 == r.cursor; }
+    };
+
+    // compare the results with the lazily evaluated sub-range, for all combinations of the paging parameters
+    for (const auto& predicate : predicates)
+    {
+        for (int since = 0; since <= 21; ++since)
+        {
+            for (int until = since; until <= 21; ++until)
+            {
+                for (size_t limit = 0; limit <= 8; ++limit)
+                {
+                    for (bool take_lower : { true, false })
+                    {
+                        int expected_until = until, expected_since = since;
+                        const auto expected = nmos::paging::cursor_based_page(resources, predicate, expected_until, expected_since, limit, take_lower);
+
+                        size_t count = 0;
+                        int actual_until = until, actual_since = since;
+                        const auto actual = nmos::paging::evaluated_cursor_based_page(resources, [&](const resource& r) { ++count; return predicate(r); }, actual_until, actual_since, limit, take_lower);
+
+                        BST_REQUIRE_EQUAL(expected_until, actual_until);
+                        BST_REQUIRE_EQUAL(expected_since, actual_since);
+                        BST_REQUIRE_EQUAL(std::distance(expected.begin(), expected.end()), (std::ptrdiff_t)actual.size());
+                        BST_REQUIRE(std::equal(actual.begin(), actual.end(), expected.begin(), [](const resource& lhs, const resource& rhs) { return lhs.cursor == rhs.cursor; }));
+
+                        // each resource is considered at most once
+                        BST_REQUIRE(count <= (size_t)(until - since));
+                    }
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEvaluatedCursorBasedPageStopsAfterLimit)
+{
+    const resources resources{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+
+    size_t count = 0;
+    const auto match = [&](const resource&) { ++count; return true; };
+
+    // "Initial /nodes Request"
+    {
+        int until = 20, since = 0;
+        auto page = nmos::paging::evaluated_cursor_based_page(resources, match, until, since, 5, true);
+        BST_REQUIRE_EQUAL(5u, page.size());
+        BST_REQUIRE_EQUAL(20, page.begin()->cursor);
+        BST_REQUIRE_EQUAL(15, since);
+        BST_REQUIRE_EQUAL(20, until);
+        // the page and the next matching resource
+        BST_REQUIRE_EQUAL(6u, count);
+    }
+
+    count = 0;
+
+    // "Request With Since Parameter"
+    {
+        int until = 20, since = 4;
+        auto page = nmos::paging::evaluated_cursor_based_page(resources, match, until, since, 5, false);
+        BST_REQUIRE_EQUAL(5u, page.size());
+        BST_REQUIRE_EQUAL(9, page.begin()->cursor);
+        BST_REQUIRE_EQUAL(4, since);
+        BST_REQUIRE_EQUAL(9, until);
+        // the page and the previous matching resource
+        BST_REQUIRE_EQUAL(6u, count);
+    }
+}
@@ -0,0 +1,438 @@
+// The first "test" is of course whether the header compiles standalone
+#include "nmos/query_utils.h"
+
+#include <algorithm>
+#include <set>
+#include "bst/test/test.h"
+#include "cpprest/basic_utils.h" // for utility::s2us
+#include "nmos/is04_versions.h"
+#include "nmos/test/resources_test_utils.h"
+#include "nmos/version.h"
+
+namespace
+{
+    web::json::value make_test_sender_data(const nmos::id& id, const nmos::id& device_id, const utility::string_t& label)
+    {
+        using web::json::value_of;
+
+        return value_of({
+            { U("id"), id },
+            { U("device_id"), device_id },
+            { U("label"), label }
+        });
+    }
+
+    bool contains(const std::vector<nmos::id>& ids, const nmos::id& id)
+    {
+        return ids.end() != std::find(ids.begin(), ids.end(), id);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testCandidateSubscriptions)
+{
+    using web::json::value_of;
+
+    const nmos::id by_device{ U("a0000000-0000-0000-0000-000000000000") };
+    const nmos::id by_label{ U("b0000000-0000-0000-0000-000000000000") };
+    const nmos::id by_rql{ U("c0000000-0000-0000-0000-000000000000") };
+    const nmos::id all_types{ U("d0000000-0000-0000-0000-000000000000") };
+    const nmos::id flows_by_device{ U("e0000000-0000-0000-0000-000000000000") };
+    const nmos::id by_device_icase{ U("f0000000-0000-0000-0000-000000000000") };
+
+    nmos::resources resources;
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(by_device, U("/senders"), value_of({ { U("device_id"), U("d1") } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(by_label, U("/senders"), value_of({ { U("label"), U("foo") } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(by_rql, U("/senders"), value_of({ { U("query.rql"), U("eq(label,bar)") } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(all_types, U(""), web::json::value::object())).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(flows_by_device, U("/flows"), value_of({ { U("device_id"), U("d1") } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(by_device_icase, U("/senders"), value_of({ { U("device_id"), U("D2") }, { U("query.match_type"), U("icase") } }))).second);
+
+    const auto sender = make_test_sender_data(U("s1"), U("d1"), U("bar"));
+
+    // an added sender
+    {
+        const auto candidates = nmos::details::get_candidate_subscriptions(resources, nmos::types::sender, web::json::value::null(), sender);
+        BST_REQUIRE_EQUAL(4u, candidates.size());
+        BST_REQUIRE(contains(candidates, by_device));
+        BST_REQUIRE(contains(candidates, by_rql));
+        BST_REQUIRE(contains(candidates, all_types));
+        BST_REQUIRE(contains(candidates, by_device_icase));
+    }
+
+    // a modified sender, which previously matched a different subscription
+    {
+        const auto candidates = nmos::details::get_candidate_subscriptions(resources, nmos::types::sender, make_test_sender_data(U("s1"), U("d1"), U("foo")), sender);
+        BST_REQUIRE_EQUAL(5u, candidates.size());
+        BST_REQUIRE(contains(candidates, by_label));
+        BST_REQUIRE(!contains(candidates, flows_by_device));
+    }
+
+    // a removed subscription is no longer a candidate
+    BST_REQUIRE_EQUAL(1u, nmos::erase_resource(resources, by_device));
+    {
+        const auto candidates = nmos::details::get_candidate_subscriptions(resources, nmos::types::sender, web::json::value::null(), sender);
+        BST_REQUIRE_EQUAL(3u, candidates.size());
+        BST_REQUIRE(!contains(candidates, by_device));
+    }
+    BST_REQUIRE(resources.subscription_routes.routes.end() == resources.subscription_routes.routes.find(by_device));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testTakeResourceEvents)
+{
+    using web::json::value_of;
+
+    const nmos::id subscription_id{ U("11111111-1111-1111-1111-111111111111") };
+    const nmos::id grain_id{ U("22222222-2222-2222-2222-222222222222") };
+
+    nmos::resources resources;
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(subscription_id, U("/senders"), value_of({ { U("device_id"), U("d1") } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_grain(grain_id, subscription_id, U("/senders/"))).second);
+
+    auto grain = nmos::find_resource(resources, { grain_id, nmos::types::grain });
+    BST_REQUIRE(resources.end() != grain);
+    const auto grain_updated = grain->updated;
+
+    // e.g. the initial 'sync' resource events are in the grain data
+    resources.modify(grain, [](nmos::resource& grain)
+    {
+        web::json::push_back(nmos::fields::message_grain_data(grain.data), nmos::details::make_resource_event(U("/senders"), nmos::types::sender, make_test_sender_data(U("s0"), U("d1"), U("foo")), make_test_sender_data(U("s0"), U("d1"), U("foo"))));
+    });
+
+    // whereas subsequent resource events are recorded without modifying the grain
+    BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(U("s1"), U("d1"), U("foo")), true }).second);
+    BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(U("s2"), U("d2"), U("foo")), true }).second);
+    BST_REQUIRE(nmos::modify_resource(resources, U("s1"), [](nmos::resource& sender)
+    {
+        sender.data[U("device_id")] = web::json::value::string(U("d2"));
+    }));
+    BST_REQUIRE(grain_updated == grain->updated);
+    BST_REQUIRE_EQUAL(1u, nmos::fields::message_grain_data(grain->data).size());
+    BST_REQUIRE_EQUAL(3u, nmos::count_resource_events(resources, *grain));
+    BST_REQUIRE_EQUAL(2u, resources.grain_events.count);
+
+    // the events are taken in order, up to the specified limit
+    const auto first = nmos::take_resource_events(resources, grain, 2);
+    BST_REQUIRE_EQUAL(2u, first.size());
+    BST_REQUIRE_EQUAL(U("s0"), first.at(0).at(U("path")).as_string());
+    BST_REQUIRE_EQUAL(nmos::details::resource_unchanged_event, nmos::details::get_resource_event_type(first.at(0)));
+    BST_REQUIRE_EQUAL(U("s1"), first.at(1).at(U("path")).as_string());
+    BST_REQUIRE_EQUAL(nmos::details::resource_added_event, nmos::details::get_resource_event_type(first.at(1)));
+    BST_REQUIRE_EQUAL(1u, nmos::count_resource_events(resources, *grain));
+
+    // the recorded event is made into the JSON resource event according to the subscription's query
+    const auto second = nmos::take_resource_events(resources, grain);
+    BST_REQUIRE_EQUAL(1u, second.size());
+    BST_REQUIRE_EQUAL(U("s1"), second.at(0).at(U("path")).as_string());
+    BST_REQUIRE_EQUAL(nmos::details::resource_removed_event, nmos::details::get_resource_event_type(second.at(0)));
+    BST_REQUIRE_EQUAL(0u, nmos::count_resource_events(resources, *grain));
+
+    // and deleting the grain drops any recorded events
+    BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(U("s3"), U("d1"), U("foo")), true }).second);
+    BST_REQUIRE_EQUAL(1u, resources.grain_events.queues.size());
+    BST_REQUIRE_EQUAL(1u, nmos::erase_resource(resources, grain_id));
+    BST_REQUIRE(resources.grain_events.queues.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// When a subscription matches more resources than the limit on the number of events per message, the initial 'sync' events
+// are sent in several messages, and none are lost
+BST_TEST_CASE(testGrainMessagePaging)
+{
+    using web::json::value;
+    using web::json::value_of;
+
+    const nmos::id subscription_id{ U("11111111-1111-1111-1111-111111111111") };
+    const nmos::id grain_id{ U("22222222-2222-2222-2222-222222222222") };
+    const size_t sender_count = 25;
+    const size_t limit = 10;
+
+    nmos::resources resources;
+    for (size_t i = 0; i < sender_count; ++i)
+    {
+        BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(U("s") + utility::s2us(std::to_string(i)), U("d1"), U("foo")), true }).second);
+    }
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(subscription_id, U("/senders"), value_of({ { U("device_id"), U("d1") } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_grain(grain_id, subscription_id, U("/senders/"))).second);
+
+    auto grain = nmos::find_resource(resources, { grain_id, nmos::types::grain });
+    BST_REQUIRE(resources.end() != grain);
+
+    // populate the grain with the initial 'sync' events, as when a websocket connection is opened
+    const auto subscription = nmos::find_resource(resources, { subscription_id, nmos::types::subscription });
+    const auto sync_events = nmos::make_resource_events(resources, *nmos::details::get_subscription_query(resources, *subscription));
+    BST_REQUIRE_EQUAL(sender_count, sync_events.size());
+    resources.modify(grain, [&sync_events](nmos::resource& grain)
+    {
+        nmos::fields::message_grain_data(grain.data) = sync_events;
+    });
+
+    std::set<utility::string_t> sent;
+    std::vector<size_t> message_sizes;
+    const auto timestamp = value::string(nmos::make_version());
+    for (size_t count = nmos::count_resource_events(resources, *grain); 0 != count; count = nmos::count_resource_events(resources, *grain))
+    {
+        BST_REQUIRE(message_sizes.size() < sender_count);
+
+        auto postponed_events = nmos::details::prepare_grain_message(resources, grain, limit, timestamp, timestamp);
+        const auto& message_events = nmos::fields::message_grain_data(grain->data);
+        BST_REQUIRE_EQUAL(count, message_events.size() + postponed_events.size());
+        message_sizes.push_back(message_events.size());
+        for (const auto& event : message_events.as_array())
+        {
+            BST_REQUIRE_EQUAL(nmos::details::resource_unchanged_event, nmos::details::get_resource_event_type(event));
+            BST_REQUIRE(sent.insert(event.at(U("path")).as_string()).second);
+        }
+
+        nmos::details::reset_grain_message(resources, grain, std::move(postponed_events));
+    }
+
+    BST_REQUIRE_EQUAL(sender_count, sent.size());
+    BST_REQUIRE((std::vector<size_t>{ limit, limit, sender_count - 2 * limit } == message_sizes));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testTakeResourcePatchEvents)
+{
+    using web::json::value;
+    using web::json::value_of;
+
+    const nmos::id subscription_id{ U("11111111-1111-1111-1111-111111111111") };
+    const nmos::id grain_id{ U("22222222-2222-2222-2222-222222222222") };
+
+    nmos::resources resources;
+
+    // modifications of resources which no subscription could match are not recorded
+    BST_REQUIRE(!nmos::details::has_candidate_subscriptions(resources, nmos::types::sender));
+    BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(U("s1"), U("d1"), U("foo")), true }).second);
+
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(subscription_id, U("/senders"), value_of({ { U("query.patch"), true } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_grain(grain_id, subscription_id, U("/senders/"))).second);
+    BST_REQUIRE(nmos::details::has_candidate_subscriptions(resources, nmos::types::sender));
+    BST_REQUIRE(!nmos::details::has_candidate_subscriptions(resources, nmos::types::receiver));
+
+    auto grain = nmos::find_resource(resources, { grain_id, nmos::types::grain });
+    BST_REQUIRE(resources.end() != grain);
+
+    BST_REQUIRE(nmos::modify_resource(resources, U("s1"), [](nmos::resource& sender)
+    {
+        sender.data[U("label")] = value::string(U("bar"));
+    }));
+    BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(U("s2"), U("d1"), U("foo")), true }).second);
+    BST_REQUIRE_EQUAL(2u, nmos::count_resource_events(resources, *grain));
+
+    const auto events = nmos::take_resource_events(resources, grain);
+    BST_REQUIRE_EQUAL(2u, events.size());
+
+    // a modified resource is described by a JSON Patch rather than both the "pre" and "post" values
+    const auto& modified = events.at(0);
+    BST_REQUIRE_EQUAL(U("s1"), modified.at(U("path")).as_string());
+    BST_REQUIRE(!modified.has_field(U("pre")));
+    BST_REQUIRE(!modified.has_field(U("post")));
+    BST_REQUIRE_EQUAL(nmos::details::resource_modified_event, nmos::details::get_resource_event_type(modified));
+    const auto expected = value_of({ value_of({ { U("op"), U("replace") }, { U("path"), U("/label") }, { U("value"), U("bar") } }) });
+    BST_REQUIRE_EQUAL(expected, modified.at(U("patch")));
+
+    // whereas an added resource is still described by its "post" value
+    const auto& added = events.at(1);
+    BST_REQUIRE_EQUAL(U("s2"), added.at(U("path")).as_string());
+    BST_REQUIRE_EQUAL(nmos::details::resource_added_event, nmos::details::get_resource_event_type(added));
+
+    // and an unchanged resource is described by an empty patch
+    BST_REQUIRE_EQUAL(nmos::details::resource_unchanged_event, nmos::details::get_resource_event_type(value_of({ { U("path"), U("s1") }, { U("patch"), value::array() } })));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Check that the compiled plan of nmos::resource_query evaluates the 'rel' operator like the interpreted RQL abstract syntax tree
+// including when the linked resource is not found
+BST_TEST_CASE(testRqlQueryPlanRel)
+{
+    using web::json::value;
+    using web::json::value_of;
+
+    nmos::id_generator make_id;
+
+    nmos::resources resources;
+
+    const auto device_id = make_id();
+    const auto insert_sender = [&](const nmos::id& flow_id, const utility::string_t& transport)
+    {
+        auto sender_data = make_test_sender_data(make_id(), device_id, U("sender"));
+        sender_data[U("flow_id")] = value::string(flow_id);
+        sender_data[U("transport")] = value::string(transport);
+        // insert with never_expire, and out-of-order since the device itself is not required
+        return nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, sender_data, true }).first;
+    };
+
+    std::vector<nmos::resources::iterator> senders;
+    for (const auto& format : { U("urn:x-nmos:format:video"), U("urn:x-nmos:format:audio") })
+    {
+        const auto flow_id = make_id();
+        BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::flow, value_of({
+            { U("id"), flow_id },
+            { U("device_id"), device_id },
+            { U("format"), value::string(format) }
+        }), true }).second);
+
+        senders.push_back(insert_sender(flow_id, U("urn:x-nmos:transport:rtp")));
+        senders.push_back(insert_sender(flow_id, U("urn:x-nmos:transport:websocket")));
+    }
+
+    const nmos::resource_query match(nmos::is04_versions::v1_3, U("/senders"), value_of({
+        { U("query.rql"), U("and(eq(transport,urn%3Ax-nmos%3Atransport%3Artp),rel(flow_id,eq(format,urn%3Ax-nmos%3Aformat%3Avideo)))") }
+    }));
+
+    for (const auto& sender : senders)
+    {
+        BST_REQUIRE_EQUAL(nmos::match_rql(sender->data, match.rql_query, resources), match(*sender, resources));
+    }
+    BST_REQUIRE(match(*senders[0], resources));
+    BST_REQUIRE(!match(*senders[1], resources));
+    BST_REQUIRE(!match(*senders[2], resources));
+
+    // the sub-query is evaluated against null when the linked resource is not found, which throws
+    const auto dangling = insert_sender(make_id(), U("urn:x-nmos:transport:rtp"));
+    BST_REQUIRE_THROW(nmos::match_rql(dangling->data, match.rql_query, resources), web::json::json_exception);
+    BST_REQUIRE_THROW(match(*dangling, resources), web::json::json_exception);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testResourceRepresentationCache)
+{
+    nmos::details::resource_representation_cache cache(2);
+
+    const nmos::details::resource_representation_cache::key_type foo{ U("foo"), nmos::is04_versions::v1_3, nmos::is04_versions::v1_3, true };
+    const nmos::details::resource_representation_cache::key_type foo_v1_2{ U("foo"), nmos::is04_versions::v1_2, nmos::is04_versions::v1_2, true };
+    const nmos::details::resource_representation_cache::key_type bar{ U("bar"), nmos::is04_versions::v1_3, nmos::is04_versions::v1_3, true };
+
+    const nmos::tai updated{ 1, 0 };
+    const nmos::tai modified{ 2, 0 };
+
+    utility::string_t representation;
+    BST_REQUIRE(!cache.find(foo, updated, representation));
+
+    cache.insert(foo, updated, U("{\"foo\":42}"));
+    BST_REQUIRE(cache.find(foo, updated, representation));
+    BST_REQUIRE_EQUAL(utility::string_t(U("{\"foo\":42}")), representation);
+
+    // the representation for each API version is distinct
+    BST_REQUIRE(!cache.find(foo_v1_2, updated, representation));
+
+    // a modified resource is not found
+    BST_REQUIRE(!cache.find(foo, modified, representation));
+    cache.insert(foo, modified, U("{\"foo\":57}"));
+    BST_REQUIRE(cache.find(foo, modified, representation));
+    BST_REQUIRE_EQUAL(utility::string_t(U("{\"foo\":57}")), representation);
+    BST_REQUIRE_EQUAL(1u, cache.size());
+
+    // when the maximum size is reached, the least recently used representation is dropped
+    cache.insert(foo_v1_2, updated, U("{}"));
+    BST_REQUIRE_EQUAL(2u, cache.size());
+    BST_REQUIRE(cache.find(foo, modified, representation));
+    cache.insert(bar, updated, U("{}"));
+    BST_REQUIRE_EQUAL(2u, cache.size());
+    BST_REQUIRE(cache.find(bar, updated, representation));
+    BST_REQUIRE(cache.find(foo, modified, representation));
+    BST_REQUIRE(!cache.find(foo_v1_2, updated, representation));
+
+    // an out-of-date representation is dropped when it is found
+    BST_REQUIRE(!cache.find(bar, modified, representation));
+    BST_REQUIRE_EQUAL(1u, cache.size());
+    BST_REQUIRE(!cache.find(bar, updated, representation));
+
+    // a maximum size of 0 disables the cache
+    nmos::details::resource_representation_cache disabled(0);
+    disabled.insert(foo, updated, U("{}"));
+    BST_REQUIRE_EQUAL(0u, disabled.size());
+    BST_REQUIRE(!disabled.find(foo, updated, representation));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testResourcePagingOfType)
+{
+    using web::json::value_of;
+
+    nmos::id_generator make_id;
+
+    nmos::resources resources;
+
+    // interleave the resources of two types, and modify some of them so the created and updated orders differ
+    std::vector<nmos::id> sender_ids;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        sender_ids.push_back(make_id());
+        BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::sender, make_test_sender_data(sender_ids.back(), make_id(), U("sender")), true }).second);
+        BST_REQUIRE(nmos::insert_resource(resources, { nmos::is04_versions::v1_3, nmos::types::flow, value_of({ { U("id"), make_id() } }), true }).second);
+    }
+    for (size_t i = 0; i < sender_ids.size(); i += 3)
+    {
+        BST_REQUIRE(nmos::modify_resource(resources, sender_ids[i], [](nmos::resource& sender)
+        {
+            sender.data[U("label")] = web::json::value::string(U("modified"));
+        }));
+    }
+
+    const auto is_sender = [](const nmos::resource& resource) { return nmos::types::sender == resource.type; };
+
+    const auto ids = [](const nmos::paging::evaluated_page<nmos::resource>& page)
+    {
+        std::vector<nmos::id> ids;
+        for (const auto& resource : page) ids.push_back(resource.id);
+        return ids;
+    };
+
+    for (auto order_by_created : { false, true })
+    {
+        for (auto since_specified : { false, true })
+        {
+            // page through all the senders, using both the type-scoped and the global indices
+            nmos::resource_paging expected(web::json::value::object(), nmos::tai_max(), 3);
+            expected.order_by_created = order_by_created;
+            expected.since_specified = since_specified;
+            nmos::resource_paging actual(expected);
+
+            size_t count = 0;
+            for (size_t p = 0; p < 5; ++p)
+            {
+                const auto expected_ids = ids(expected.page(resources, is_sender));
+                const auto actual_ids = ids(actual.page(resources, nmos::types::sender, is_sender));
+                BST_REQUIRE(expected_ids == actual_ids);
+                BST_REQUIRE(expected.until == actual.until);
+                BST_REQUIRE(expected.since == actual.since);
+
+                count += actual_ids.size();
+
+                // next page
+                if (since_specified)
+                {
+                    actual.since = expected.since = expected.until;
+                    actual.until = expected.until = nmos::tai_max();
+                }
+                else
+                {
+                    actual.until = expected.until = expected.since;
+                    actual.since = expected.since = nmos::tai_min();
+                }
+            }
+            BST_REQUIRE_EQUAL(sender_ids.size(), count);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testSerializeGrainMessage)
+{
+    auto message = nmos::details::make_grain(U("source"), U("flow"), U("/senders/"));
+    nmos::fields::grain_data(message) = web::json::value_of({
+        nmos::details::make_resource_event(U("/senders"), nmos::types::sender, web::json::value::null(), make_test_sender_data(U("s1"), U("d1"), U("foo"))),
+        nmos::details::make_resource_event(U("/senders"), nmos::types::sender, make_test_sender_data(U("s2"), U("d1"), U("bar")), web::json::value::null())
+    });
+
+    const auto serialized_data = utility::us2s(nmos::fields::grain_data(message).serialize());
+    BST_REQUIRE_EQUAL(utility::us2s(message.serialize()), nmos::details::serialize_grain_message(message, serialized_data));
+
+    // the serialized grain data is used regardless of the grain data in the message
+    const auto empty = nmos::details::make_grain(U("source"), U("flow"), U("/senders/"));
+    BST_REQUIRE_EQUAL(utility::us2s(message.serialize()), nmos::details::serialize_grain_message(empty, serialized_data));
+}
@@ -3,6 +3,8 @@
 
 #include "bst/test/test.h"
 #include "nmos/is04_versions.h"
+#include "nmos/query_utils.h"
+#include "nmos/test/resources_test_utils.h"
 
 namespace
 {
@@ -72,3 +74,125 @@ BST_TEST_CASE(testInsertResourceRecordsSubResources)
 
     BST_REQUIRE_EQUAL(2u, nmos::erase_resource(resources, node_id));
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testSubscriptionQueriesAreCompiledOnceAndDropped)
+{
+    using web::json::value_of;
+
+    const nmos::id subscription_id{ U("44444444-4444-4444-4444-444444444444") };
+    const nmos::id grain_id{ U("55555555-5555-5555-5555-555555555555") };
+    const nmos::id node_id{ U("66666666-6666-6666-6666-666666666666") };
+
+    nmos::resources resources;
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_subscription(subscription_id, U("/nodes"), value_of({ { U("id"), node_id } }))).second);
+    BST_REQUIRE(nmos::insert_resource(resources, nmos::make_test_grain(grain_id, subscription_id, U("/nodes/"))).second);
+
+    // the subscription query is compiled on insertion
+    const auto compiled = resources.subscription_queries.find(subscription_id);
+    BST_REQUIRE(resources.subscription_queries.end() != compiled);
+    BST_REQUIRE_EQUAL(U("/nodes"), compiled->second->resource_path);
+
+    // and used to match resource events
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_node(node_id)).second);
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_node(U("77777777-7777-7777-7777-777777777777"))).second);
+    {
+        const auto grain = nmos::find_resource(resources, { grain_id, nmos::types::grain });
+        BST_REQUIRE(resources.end() != grain);
+        BST_REQUIRE_EQUAL(1u, nmos::count_resource_events(resources, *grain));
+    }
+
+    // modifying the subscription parameters recompiles the query
+    BST_REQUIRE(nmos::modify_resource(resources, subscription_id, [](nmos::resource& subscription)
+    {
+        subscription.data[nmos::fields::params] = web::json::value::object();
+    }));
+    BST_REQUIRE(resources.subscription_queries.at(subscription_id)->basic_query.as_object().empty());
+
+    // and deleting the subscription drops it
+    BST_REQUIRE_EQUAL(2u, nmos::erase_resource(resources, subscription_id, false));
+    BST_REQUIRE(resources.subscription_queries.end() == resources.subscription_queries.find(subscription_id));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testEraseExpiredResourcesByHealthIndex)
+{
+    const nmos::id node1_id{ U("88888888-8888-8888-8888-888888888888") };
+    const nmos::id device1_id{ U("99999999-9999-9999-9999-999999999999") };
+    const nmos::id node2_id{ U("aaaaaaaa-aaaa-aaaa-aaaa-aaaaaaaaaaaa") };
+    const nmos::id device2_id{ U("bbbbbbbb-bbbb-bbbb-bbbb-bbbbbbbbbbbb") };
+
+    nmos::resources resources;
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_node(node1_id)).second);
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_device(device1_id, node1_id)).second);
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_node(node2_id)).second);
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_device(device2_id, node2_id)).second);
+
+    const auto now = nmos::health_now();
+
+    // heartbeats are only recorded for the nodes, the devices inherit their health
+    nmos::set_resource_health(resources, node1_id, now - 100);
+    nmos::set_resource_health(resources, node2_id, now - 50);
+    BST_REQUIRE_EQUAL(now - 100, nmos::least_health(resources).first);
+
+    // only the first node and its device have expired
+    BST_REQUIRE_EQUAL(2u, nmos::erase_expired_resources(resources, now - 75, false));
+    BST_REQUIRE(!nmos::has_resource(resources, { node1_id, nmos::types::node }));
+    BST_REQUIRE(!nmos::has_resource(resources, { device1_id, nmos::types::device }));
+    BST_REQUIRE(nmos::has_resource(resources, { device2_id, nmos::types::device }));
+
+    auto least_health = nmos::least_health(resources);
+    BST_REQUIRE_EQUAL(now - 50, least_health.first);
+    BST_REQUIRE_EQUAL(now - 100, least_health.second);
+
+    // a heartbeat keeps the second node and its device alive
+    nmos::set_resource_health(resources, node2_id, now);
+    BST_REQUIRE_EQUAL(0u, nmos::erase_expired_resources(resources, now - 25, false));
+    BST_REQUIRE(nmos::has_resource(resources, { device2_id, nmos::types::device }));
+
+    BST_REQUIRE_EQUAL(2u, nmos::forget_erased_resources(resources, now - 75));
+    BST_REQUIRE_EQUAL(2u, nmos::erase_expired_resources(resources, now + 1));
+    BST_REQUIRE(resources.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testSetResourceHealthInheritance)
+{
+    const nmos::id node_id{ U("cccccccc-cccc-cccc-cccc-cccccccccccc") };
+    const nmos::id device1_id{ U("dddddddd-dddd-dddd-dddd-dddddddddddd") };
+    const nmos::id device2_id{ U("eeeeeeee-eeee-eeee-eeee-eeeeeeeeeeee") };
+
+    nmos::resources resources;
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_node(node_id)).second);
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_device(device1_id, node_id)).second);
+    BST_REQUIRE(nmos::insert_resource(resources, make_test_device(device2_id, node_id)).second);
+
+    const auto node = nmos::find_resource(resources, { node_id, nmos::types::node });
+    const auto device1 = nmos::find_resource(resources, { device1_id, nmos::types::device });
+    const auto device2 = nmos::find_resource(resources, { device2_id, nmos::types::device });
+
+    // the devices inherit the health of the node
+    BST_REQUIRE(device1->health.inherits(node->health));
+    BST_REQUIRE(device2->health.inherits(node->health));
+
+    nmos::set_resource_health(resources, node_id, 1000);
+    BST_REQUIRE_EQUAL(1000, device1->health.load());
+    BST_REQUIRE_EQUAL(1000, device2->health.load());
+
+    // setting the health of a device doesn't affect the node or the other device
+    nmos::set_resource_health(resources, device1_id, 2000);
+    BST_REQUIRE_EQUAL(1000, node->health.load());
+    BST_REQUIRE_EQUAL(2000, device1->health.load());
+    BST_REQUIRE_EQUAL(1000, device2->health.load());
+
+    // but the next heartbeat for the node sets the health of all its sub-resources again
+    nmos::set_resource_health(resources, node_id, 3000);
+    BST_REQUIRE_EQUAL(3000, device1->health.load());
+    BST_REQUIRE(device1->health.inherits(node->health));
+
+    // an erased sub-resource stops inheriting the health of its super-resource
+    BST_REQUIRE_EQUAL(1u, nmos::erase_resource(resources, device2_id, false));
+    nmos::set_resource_health(resources, node_id, 4000);
+    BST_REQUIRE_EQUAL(3000, device2->health.load());
+    BST_REQUIRE_EQUAL(4000, device1->health.load());
+}
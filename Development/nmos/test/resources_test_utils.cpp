@@ -0,0 +1,31 @@
+#include "nmos/test/resources_test_utils.h"
+
+#include "nmos/is04_versions.h"
+#include "nmos/query_utils.h"
+
+namespace nmos
+{
+    nmos::resource make_test_subscription(const nmos::id& id, const utility::string_t& resource_path, const web::json::value& params)
+    {
+        using web::json::value_of;
+
+        return{ nmos::is04_versions::v1_3, nmos::types::subscription, value_of({
+            { U("id"), id },
+            { U("resource_path"), resource_path },
+            { U("params"), params },
+            { U("persist"), true },
+            { U("max_update_rate_ms"), 100 }
+        }), true };
+    }
+
+    nmos::resource make_test_grain(const nmos::id& id, const nmos::id& subscription_id, const utility::string_t& topic)
+    {
+        using web::json::value_of;
+
+        return{ nmos::is04_versions::v1_3, nmos::types::grain, value_of({
+            { U("id"), id },
+            { U("subscription_id"), subscription_id },
+            { U("message"), nmos::details::make_grain({}, {}, topic) }
+        }), true };
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef NMOS_RESOURCES_TEST_UTILS_H
+#define NMOS_RESOURCES_TEST_UTILS_H
+
+#include "nmos/resource.h"
+
+namespace nmos
+{
+    // make a persistent Query API subscription to the specified resource path with the specified query parameters
+    nmos::resource make_test_subscription(const nmos::id& id, const utility::string_t& resource_path, const web::json::value& params);
+
+    // make a websocket connection grain for the specified subscription, with the specified topic, e.g. "/senders/"
+    nmos::resource make_test_grain(const nmos::id& id, const nmos::id& subscription_id, const utility::string_t& topic);
+}
+
+#endif
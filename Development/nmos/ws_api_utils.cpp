@@ -1,5 +1,6 @@
 #include "nmos/ws_api_utils.h"
 
+#include "cpprest/basic_utils.h" // for utility::us2s
 #include "cpprest/http_utils.h"
 #include "nmos/api_utils.h"
 #include "nmos/authorization.h"
@@ -57,4 +58,24 @@ namespace nmos
             };
         }
     }
+
+    namespace details
+    {
+        std::shared_ptr<const std::string> serialization_cache::serialize(const web::json::value& value, const utility::string_t& hint)
+        {
+            const key_type key{ hint, value.size() };
+            const auto range = serialized.equal_range(key);
+            for (auto it = range.first; range.second != it; ++it)
+            {
+                if (*it->second.first == value)
+                {
+                    ++hits_;
+                    return it->second.second;
+                }
+            }
+            auto result = std::make_shared<const std::string>(utility::us2s(value.serialize()));
+            serialized.insert({ key, { &value, result } });
+            return result;
+        }
+    }
 }
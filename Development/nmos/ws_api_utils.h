@@ -2,6 +2,8 @@
 #define NMOS_WS_API_UTILS_H
 
 #include <functional>
+#include <map>
+#include <memory>
 #include "cpprest/http_msg.h"
 #include "nmos/authorization_handlers.h"
 
@@ -21,6 +23,29 @@ namespace nmos
         typedef std::function<bool(web::http::http_request& request, const nmos::experimental::scope& scope)> ws_validate_authorization_handler;
         ws_validate_authorization_handler make_ws_validate_authorization_handler(nmos::base_model& model, authorization_state& authorization_state, validate_authorization_token_handler access_token_validation, slog::base_gate& gate);
     }
+
+    namespace details
+    {
+        // Cache of serialized JSON values, so that a value which is sent on many websocket connections, e.g. the events of subscriptions
+        // with the same resource path and query parameters, is only serialized once
+        // Identical values are found by comparison with the values already serialized, which therefore must outlive the cache;
+        // the hint, e.g. the grain topic or the source id, and the size of the value are used to limit the number of comparisons
+        class serialization_cache
+        {
+        public:
+            serialization_cache() : hits_(0) {}
+
+            std::shared_ptr<const std::string> serialize(const web::json::value& value, const utility::string_t& hint);
+
+            // number of times a value was found already serialized
+            size_t hits() const { return hits_; }
+
+        private:
+            typedef std::pair<utility::string_t, size_t> key_type;
+            std::multimap<key_type, std::pair<const web::json::value*, std::shared_ptr<const std::string>>> serialized;
+            size_t hits_;
+        };
+    }
 }
 
 #endif
@@ -1,10 +1,13 @@
 #include "rql/rql.h"
 
+#include <algorithm>
 #include <stack>
 #include <stdexcept>
+#include <boost/algorithm/string/split.hpp>
 #include "cpprest/base_uri.h" // for uri::decode
 #include "cpprest/basic_utils.h"
 #include "cpprest/json_ops.h"
+#include "cpprest/json_utils.h" // for web::json::extract
 #include "cpprest/regex_utils.h"
 
 namespace rql
@@ -382,6 +385,29 @@ namespace rql
         }
     }
 
+    // Construct the default resource property extractor
+
+    extractor make_extractor(const web::json::value& value)
+    {
+        return [&value](web::json::value& results, const web::json::value& key_path_)
+        {
+            if (key_path_.is_array())
+            {
+                std::vector<utility::string_t> key_path;
+                for (const auto& key : key_path_.as_array())
+                {
+                    key_path.push_back(key.as_string());
+                }
+
+                return web::json::extract(value.as_object(), results, key_path);
+            }
+            else
+            {
+                return web::json::extract(value.as_object(), results, key_path_.as_string());
+            }
+        };
+    }
+
     // Helpers for json value comparison, implementing three-valued (tribool) logic
 
     web::json::value default_equal_to(const web::json::value& lhs, const web::json::value& rhs)
@@ -777,4 +803,455 @@ namespace rql
     {
         return details::default_any_operators(equal_to, less);
     }
+
+    // Compile an RQL query into a reusable plan
+
+    namespace details
+    {
+        struct plan_node
+        {
+            enum kind_type
+            {
+                constant_node, // a value rather than a call-operator, e.g. an argument of a logical operator
+                and_node,
+                or_node,
+                not_node,
+                eq_node,
+                ne_node,
+                gt_node,
+                ge_node,
+                lt_node,
+                le_node,
+                in_node,
+                out_node,
+                contains_node,
+                excludes_node,
+                null_node,
+                matches_node,
+                relation_node,
+                fallback_node // any other call-operator, evaluated by an evaluator
+            };
+
+            kind_type kind;
+
+            // for constant_node
+            boost::tribool constant;
+
+            // for the relational, set relation, filter and relation nodes, the property key path
+            std::vector<utility::string_t> key_path;
+
+            // for the relational and set relation nodes, the value to compare, and for fallback_node, the call-operator
+            web::json::value value;
+
+            // for matches_node
+            utility::regex_t regex;
+
+            // for relation_node, the relation operator and relation-name
+            utility::string_t relation_operator;
+            utility::string_t relation_name;
+
+            // for the logical operator nodes, and the sub-query of relation_node
+            std::vector<plan_node> args;
+        };
+
+        struct plan
+        {
+            plan_node root;
+            comparator equal_to;
+            comparator less;
+        };
+
+        inline boost::tribool tribool_from(const web::json::value& result)
+        {
+            return result.is_boolean() ? boost::tribool(result.as_bool()) : boost::tribool(boost::indeterminate);
+        }
+
+        // cf. details::includes, which is false rather than indeterminate
+        inline boost::tribool true_or_false(boost::tribool result)
+        {
+            return result ? true : false;
+        }
+
+        // split the property key in the same way as make_extractor, or return false to indicate it's not a valid key
+        static bool make_key_path(std::vector<utility::string_t>& key_path, const web::json::value& key)
+        {
+            if (key.is_string())
+            {
+                boost::algorithm::split(key_path, key.as_string(), [](utility::char_t c) { return U('.') == c; });
+                return true;
+            }
+            else if (key.is_array() && 0 != key.size())
+            {
+                for (const auto& element : key.as_array())
+                {
+                    if (!element.is_string()) return false;
+                    key_path.push_back(element.as_string());
+                }
+                return true;
+            }
+            return false;
+        }
+
+        static plan_node compile_node(const web::json::value& arg, const std::vector<utility::string_t>& relation_operators)
+        {
+            plan_node node;
+
+            if (!is_call_operator(arg))
+            {
+                // cf. evaluator::operator(), which returns the value itself
+                node.kind = plan_node::constant_node;
+                node.constant = tribool_from(arg);
+                return node;
+            }
+
+            // anything unexpected is left to the evaluator, to report errors in just the same way
+            node.kind = plan_node::fallback_node;
+
+            const auto& name_ = arg.at(U("name"));
+            const auto& args = arg.at(U("args"));
+            if (!name_.is_string() || !args.is_array()) { node.value = arg; return node; }
+
+            const auto& name = name_.as_string();
+            const auto size = args.size();
+            const bool property_arg = 1 <= size && !is_call_operator(args.at(0));
+            const bool value_arg = 2 <= size && !is_call_operator(args.at(1));
+
+            static const std::unordered_map<utility::string_t, plan_node::kind_type> property_value_kinds
+            {
+                { U("eq"), plan_node::eq_node },
+                { U("ne"), plan_node::ne_node },
+                { U("gt"), plan_node::gt_node },
+                { U("ge"), plan_node::ge_node },
+                { U("lt"), plan_node::lt_node },
+                { U("le"), plan_node::le_node },
+                { U("in"), plan_node::in_node },
+                { U("out"), plan_node::out_node },
+                { U("contains"), plan_node::contains_node },
+                { U("excludes"), plan_node::excludes_node }
+            };
+
+            if (U("and") == name || U("or") == name)
+            {
+                node.kind = U("and") == name ? plan_node::and_node : plan_node::or_node;
+                for (const auto& a : args.as_array())
+                {
+                    node.args.push_back(compile_node(a, relation_operators));
+                }
+            }
+            else if (U("not") == name && 1 <= size)
+            {
+                node.kind = plan_node::not_node;
+                node.args.push_back(compile_node(args.at(0), relation_operators));
+            }
+            else if (relation_operators.end() != std::find(relation_operators.begin(), relation_operators.end(), name))
+            {
+                // the relation-name must be a string, and the sub-query is evaluated against the related value
+                if (2 <= size && args.at(0).is_string() && make_key_path(node.key_path, args.at(0)))
+                {
+                    node.kind = plan_node::relation_node;
+                    node.relation_operator = name;
+                    node.relation_name = args.at(0).as_string();
+                    node.args.push_back(compile_node(args.at(1), relation_operators));
+                }
+            }
+            else if (property_value_kinds.end() != property_value_kinds.find(name))
+            {
+                if (property_arg && value_arg && make_key_path(node.key_path, args.at(0)))
+                {
+                    node.kind = property_value_kinds.at(name);
+                    node.value = args.at(1);
+                }
+            }
+            else if (U("null") == name)
+            {
+                if (property_arg && make_key_path(node.key_path, args.at(0)))
+                {
+                    node.kind = plan_node::null_node;
+                }
+            }
+            else if (U("matches") == name)
+            {
+                const auto& pattern = 2 <= size ? args.at(1) : value_indeterminate;
+                const auto& options = 3 <= size ? args.at(2) : web::json::value::string(U(""));
+                if (property_arg && pattern.is_string() && options.is_string() && make_key_path(node.key_path, args.at(0)))
+                {
+                    try
+                    {
+                        // cf. details::matches
+                        const auto flags = U("i") == options.as_string() ? utility::regex_t::flag_type(utility::regex_t::icase) : utility::regex_t::flag_type(0);
+                        node.regex = utility::regex_t(pattern.as_string(), flags);
+                        node.kind = plan_node::matches_node;
+                    }
+                    catch (const std::runtime_error&) // i.e. bst::regex_error
+                    {
+                        // report the invalid pattern at evaluation time, like the evaluator
+                    }
+                }
+            }
+
+            if (plan_node::fallback_node == node.kind)
+            {
+                node.key_path.clear();
+                node.value = arg;
+            }
+
+            return node;
+        }
+
+        struct plan_context
+        {
+            const details::plan& compiled;
+            const query_plan::relation_resolver& resolve;
+            const std::function<operators()>& make_operators;
+            // made on first use by a fallback_node
+            std::unique_ptr<operators> fallback_operators;
+        };
+
+        enum find_result
+        {
+            found_none,
+            found_one,
+            found_array // an array was encountered before the leaf key, so the results must be extracted
+        };
+
+        // find the value identified by the key path without copying it, as long as no arrays are encountered on the way
+        static find_result find_value(const web::json::value& data, const std::vector<utility::string_t>& key_path, const web::json::value*& found)
+        {
+            // let web::json::extract handle (i.e. throw for) anything other than an object, like the extractor
+            if (!data.is_object()) return found_array;
+
+            const web::json::object* object = &data.as_object();
+            for (size_t i = 0; i < key_path.size(); ++i)
+            {
+                const auto field = object->find(key_path[i]);
+                if (object->end() == field) return found_none;
+
+                const auto& value = field->second;
+                if (key_path.size() == i + 1)
+                {
+                    found = &value;
+                    return found_one;
+                }
+                if (value.is_array()) return found_array;
+                if (!value.is_object()) return found_none;
+                object = &value.as_object();
+            }
+            return found_none;
+        }
+
+        // cf. evaluator::operator() for a property key, with extract_value = true
+        template <typename Function>
+        boost::tribool with_extracted(const web::json::value& data, const std::vector<utility::string_t>& key_path, Function f)
+        {
+            const web::json::value* found = &value_indeterminate;
+            if (found_array != find_value(data, key_path, found)) return f(*found);
+
+            web::json::value results;
+            web::json::extract(data.as_object(), results, key_path);
+            return f(results);
+        }
+
+        // cf. details::logical_or
+        template <typename ThreeStatePredicate>
+        boost::tribool any_of(const web::json::value& values, ThreeStatePredicate predicate)
+        {
+            if (!values.is_array())
+            {
+                return predicate(values);
+            }
+            bool indeterminate = false;
+            for (const auto& value : values.as_array())
+            {
+                const auto result = predicate(value);
+                if (boost::indeterminate(result))
+                {
+                    indeterminate = true;
+                }
+                else if (result)
+                {
+                    return true;
+                }
+            }
+            return indeterminate ? boost::tribool(boost::indeterminate) : boost::tribool(false);
+        }
+
+        // cf. default_equal_to, without constructing a result value
+        static boost::tribool equal_to(const plan& compiled, const web::json::value& lhs, const web::json::value& rhs)
+        {
+            if (is_typed_value(lhs) || is_typed_value(rhs)) return tribool_from(compiled.equal_to(lhs, rhs));
+
+            if (lhs.type() != rhs.type()) return boost::indeterminate;
+            if (lhs.is_number()) return lhs.as_double() == rhs.as_double();
+            return lhs == rhs;
+        }
+
+        // cf. default_less, without constructing a result value
+        static boost::tribool less(const plan& compiled, const web::json::value& lhs, const web::json::value& rhs)
+        {
+            if (is_typed_value(lhs) || is_typed_value(rhs)) return tribool_from(compiled.less(lhs, rhs));
+
+            if (lhs.type() != rhs.type()) return boost::indeterminate;
+            if (lhs.is_string()) return lhs.as_string() < rhs.as_string();
+            if (lhs.is_number()) return lhs.as_double() < rhs.as_double();
+            return boost::indeterminate;
+        }
+
+        static boost::tribool evaluate(const plan_node& node, const web::json::value& data, plan_context& context)
+        {
+            const auto& compiled = context.compiled;
+            const auto& value = node.value;
+
+            switch (node.kind)
+            {
+            case plan_node::constant_node:
+                return node.constant;
+
+            case plan_node::and_node:
+            case plan_node::or_node:
+            {
+                // short-circuit conjunction or disjunction, cf. functions::logical_and and functions::logical_or
+                const bool conjunction = plan_node::and_node == node.kind;
+                bool indeterminate = false;
+                for (const auto& arg : node.args)
+                {
+                    const auto result = evaluate(arg, data, context);
+                    if (boost::indeterminate(result))
+                    {
+                        indeterminate = true;
+                    }
+                    else if (conjunction != bool(result))
+                    {
+                        return !conjunction;
+                    }
+                }
+                return indeterminate ? boost::tribool(boost::indeterminate) : boost::tribool(conjunction);
+            }
+
+            case plan_node::not_node:
+                return !evaluate(node.args.front(), data, context);
+
+            // array-friendly relational operators, cf. functions::any_eq, etc.
+
+            case plan_node::eq_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& property) { return equal_to(compiled, property, value); });
+                });
+            case plan_node::ne_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& property) { return !equal_to(compiled, property, value); });
+                });
+            case plan_node::gt_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& property) { return less(compiled, value, property); });
+                });
+            case plan_node::ge_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& property) { return !less(compiled, property, value); });
+                });
+            case plan_node::lt_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& property) { return less(compiled, property, value); });
+                });
+            case plan_node::le_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& property) { return !less(compiled, value, property); });
+                });
+
+            // set relation functions, cf. functions::in, etc.
+
+            case plan_node::in_node:
+            case plan_node::out_node:
+            {
+                const auto result = with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return true_or_false(any_of(value, [&](const web::json::value& element) { return equal_to(compiled, element, extracted); }));
+                });
+                return plan_node::in_node == node.kind ? result : !result;
+            }
+            case plan_node::contains_node:
+            case plan_node::excludes_node:
+            {
+                const auto result = with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return true_or_false(any_of(extracted, [&](const web::json::value& element) { return equal_to(compiled, element, value); }));
+                });
+                return plan_node::contains_node == node.kind ? result : !result;
+            }
+
+            // additional filter functions, cf. functions::null and functions::any_matches
+
+            case plan_node::null_node:
+            {
+                // null distinguishes a null value from property key not found
+                const web::json::value* found = &value_indeterminate;
+                const auto find = find_value(data, node.key_path, found);
+                if (found_none == find) return boost::indeterminate;
+                if (found_one == find) return found->is_null();
+
+                web::json::value results;
+                if (!web::json::extract(data.as_object(), results, node.key_path)) return boost::indeterminate;
+                return results.is_null();
+            }
+            case plan_node::matches_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& target)
+                    {
+                        return target.is_string() ? boost::tribool(bst::regex_search(target.as_string(), node.regex)) : boost::tribool(boost::indeterminate);
+                    });
+                });
+
+            // relation operators, cf. nmos::experimental::relation_query
+
+            case plan_node::relation_node:
+                return with_extracted(data, node.key_path, [&](const web::json::value& extracted)
+                {
+                    return any_of(extracted, [&](const web::json::value& relation_value)
+                    {
+                        const auto related = context.resolve(node.relation_operator, node.relation_name, relation_value);
+                        return nullptr != related ? evaluate(node.args.front(), *related, context) : boost::tribool(boost::indeterminate);
+                    });
+                });
+
+            case plan_node::fallback_node:
+            default:
+            {
+                if (!context.fallback_operators)
+                {
+                    context.fallback_operators.reset(new operators(context.make_operators()));
+                }
+                return tribool_from(evaluator{ make_extractor(data), *context.fallback_operators }(value));
+            }
+            }
+        }
+    }
+
+    boost::tribool query_plan::operator()(const web::json::value& value, const relation_resolver& resolve, const std::function<operators()>& make_operators) const
+    {
+        if (!impl) return boost::indeterminate;
+
+        details::plan_context context{ *impl, resolve, make_operators, {} };
+        return details::evaluate(impl->root, value, context);
+    }
+
+    boost::tribool query_plan::operator()(const web::json::value& value) const
+    {
+        return (*this)(value, {}, [] { return default_any_operators(); });
+    }
+
+    query_plan compile_query(const web::json::value& query)
+    {
+        return compile_query(query, default_equal_to, default_less);
+    }
+
+    query_plan compile_query(const web::json::value& query, comparator equal_to, comparator less, const std::vector<utility::string_t>& relation_operators)
+    {
+        return query_plan(std::make_shared<details::plan>(details::plan{ details::compile_node(query, relation_operators), std::move(equal_to), std::move(less) }));
+    }
 }
@@ -2,7 +2,10 @@
 #define RQL_RQL_H
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
+#include <vector>
+#include <boost/logic/tribool.hpp>
 #include "cpprest/json.h"
 
 namespace rql
@@ -32,6 +35,11 @@ namespace rql
     typedef std::function<bool(web::json::value& results, const web::json::value& key)> extractor;
     typedef std::unordered_map<utility::string_t, std::function<web::json::value(const evaluator& eval, const web::json::value& args)>> operators;
 
+    // Construct the default resource property extractor, for which the key is either a string, in which '.' separates the keys
+    // of nested objects, or an array of keys, and which searches arrays as necessary, like web::json::extract
+
+    extractor make_extractor(const web::json::value& value);
+
     void validate_query(const web::json::value& query); // with default call-operators
     void validate_query(const web::json::value& query, const operators& operators);
 
@@ -68,6 +76,43 @@ namespace rql
 
     web::json::value default_equal_to(const web::json::value& lhs, const web::json::value& rhs);
     web::json::value default_less(const web::json::value& lhs, const web::json::value& rhs);
+
+    // Compile an RQL query into a reusable plan, for evaluating the same query against many values
+    // The plan is a tree of typed nodes, in which the call-operators are resolved, the property key paths are split and the regex
+    // patterns are constructed up front, so that evaluation does not look up the call-operators by name for each call, nor copy
+    // the property values or the values being compared, and in the common case doesn't allocate at all.
+    // The plan implements the array-friendly call-operators (see default_any_operators), using default json value comparison except
+    // for typed values, which are compared using the specified comparators, as well as the specified relation operators, of the form
+    // relation(<relation-name>, <call-operator>), for which the related value is found using a resolver when the plan is evaluated.
+    // Other call-operators, such as count, get and value, and the extended forms of the relational operators, are evaluated by an
+    // evaluator, using the set of call-operators made when the plan is evaluated, only if required.
+
+    namespace details
+    {
+        struct plan;
+    }
+
+    class query_plan
+    {
+    public:
+        // find the value related to the specified relation value by a relation operator (e.g. the linked data for "rel")
+        // or return nullptr, to make the sub-query indeterminate
+        typedef std::function<const web::json::value*(const utility::string_t& relation_operator, const utility::string_t& relation_name, const web::json::value& relation_value)> relation_resolver;
+
+        // a default-constructed plan, like a null query, is indeterminate for every value
+        query_plan() {}
+        explicit query_plan(std::shared_ptr<const details::plan> impl) : impl(std::move(impl)) {}
+
+        // evaluate the plan, the result following the three-valued logic of the call-operators
+        boost::tribool operator()(const web::json::value& value, const relation_resolver& resolve, const std::function<operators()>& make_operators) const;
+        boost::tribool operator()(const web::json::value& value) const; // with no relation operators, and default array-friendly call-operators
+
+    private:
+        std::shared_ptr<const details::plan> impl;
+    };
+
+    query_plan compile_query(const web::json::value& query); // with default json value comparison, and no relation operators
+    query_plan compile_query(const web::json::value& query, comparator equal_to, comparator less, const std::vector<utility::string_t>& relation_operators = {});
 }
 
 #endif
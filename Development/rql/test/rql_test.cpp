@@ -72,3 +72,55 @@ BST_TEST_CASE(testRqlValidateQuery)
         BST_REQUIRE_THROW(rql::validate_query(rql_query, operators), std::runtime_error);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////
+BST_TEST_CASE(testRqlQueryPlan)
+{
+    using web::json::value;
+
+    const auto data = value::parse(U(R"-json-({
+        "label": "Foo", "n": 3, "z": null, "b": true,
+        "tags": { "x": [ "1", "2" ] },
+        "arr": [ { "k": 1, "m": "p" }, { "k": 2 }, 3 ],
+        "nested": { "deep": { "v": "q" } }
+    })-json-"));
+
+    const auto operators = rql::default_any_operators();
+
+    // the compiled plan gives the same results as the evaluator, including for the indeterminate cases
+    const utility::string_t queries[] = {
+        U("eq(label,Foo)"), U("ne(label,Foo)"), U("lt(n,4)"), U("le(n,2)"), U("gt(label,a)"), U("ge(n,string:3)"),
+        U("eq(z,null)"), U("eq(nope,1)"), U("eq(b,true)"),
+        U("in(label,(Foo,bar))"), U("out(n,(1,3))"), U("contains(tags.x,1)"), U("excludes(tags.x,3)"),
+        U("eq(arr.k,2)"), U("ne(arr.k,1)"), U("eq((nested,deep,v),q)"), U("eq(nested.deep.v,r)"),
+        U("null(z)"), U("null(label)"), U("null(nope)"), U("null(arr.m)"),
+        U("matches(label,%5Ef,i)"), U("matches(label,%5Ef)"), U("matches(n,x)"),
+        U("and(eq(label,Foo),lt(n,4))"), U("and(eq(label,Foo),eq(nope,1))"), U("or(eq(nope,1),eq(label,Foo))"), U("not(eq(nope,1))"),
+        U("and()"), U("or(false,string:x)"), U("not(true)"),
+        U("eq(count(tags.x),2)"), U("eq(get(value(label)),Foo)"), U("eq(count(arr),3)")
+    };
+    for (const auto& query_rql : queries)
+    {
+        const auto query = rql::parse_query(query_rql);
+        const auto plan = rql::compile_query(query);
+
+        const auto expected = rql::evaluator{ rql::make_extractor(data), operators }(query);
+        const auto actual = plan(data);
+        BST_REQUIRE_EQUAL(expected, boost::indeterminate(actual) ? rql::value_indeterminate : actual ? rql::value_true : rql::value_false);
+    }
+
+    // unimplemented call-operators are reported when evaluated, just like the evaluator
+    BST_REQUIRE_THROW(rql::compile_query(rql::parse_query(U("meow(label)")))(data), std::runtime_error);
+
+    // relation operators are evaluated against the value found by the resolver
+    {
+        const auto plan = rql::compile_query(rql::parse_query(U("sub(nested.deep,eq(v,q))")), rql::default_equal_to, rql::default_less, { U("sub") });
+        const auto resolve = [](const utility::string_t& relation_operator, const utility::string_t& relation_name, const web::json::value& relation_value) -> const web::json::value*
+        {
+            return relation_value.is_object() ? &relation_value : nullptr;
+        };
+        const auto make_operators = [] { return rql::default_any_operators(); };
+        BST_REQUIRE(bool(plan(data, resolve, make_operators)));
+        BST_REQUIRE(boost::indeterminate(plan(value::object(), resolve, make_operators)));
+    }
+}
@@ -62,6 +62,14 @@ namespace sdp
         // for now, leading zeros are not roundtrippable
         inline web::json::value digits2jn(const std::string& s)
         {
+            // fast path for the usual case, a sequence of digits short enough that it cannot overflow
+            if (!s.empty() && s.size() < 20 && std::string::npos == s.find_first_not_of("0123456789"))
+            {
+                uint64_t v = 0;
+                for (const auto c : s) v = v * 10 + uint64_t(c - '0');
+                return web::json::value(v);
+            }
+
             uint64_t v;
             std::istringstream is(s);
             is >> v;
@@ -109,6 +117,59 @@ namespace sdp
             return substr;
         }
 
+        // a delimiter matcher finds the first delimiter in str, beginning at pos, and returns its position (or npos) and length
+        // the delimiters of the default grammar which are patterns rather than fixed strings are matched by these functions
+        // since constructing a regex, and even just searching with one, is relatively expensive for every value
+        typedef std::pair<std::string::size_type, std::string::size_type>(*delimiter_matcher)(const std::string& str, std::string::size_type pos);
+
+        // equivalent to the regex "[ \t]+"
+        inline std::pair<std::string::size_type, std::string::size_type> match_whitespace(const std::string& str, std::string::size_type pos)
+        {
+            const auto first = str.find_first_of(" \t", pos);
+            if (std::string::npos == first) return{ std::string::npos, 0 };
+            const auto last = str.find_first_not_of(" \t", first);
+            return{ first, (std::string::npos != last ? last : str.size()) - first };
+        }
+
+        // equivalent to the regex R"(\D)"
+        inline std::pair<std::string::size_type, std::string::size_type> match_non_digit(const std::string& str, std::string::size_type pos)
+        {
+            const auto first = str.find_first_not_of("0123456789", pos);
+            return{ first, std::string::size_type(std::string::npos != first ? 1 : 0) };
+        }
+
+        // equivalent to the regex "[ \t]*(;[ \t]*|$)"
+        inline std::pair<std::string::size_type, std::string::size_type> match_semicolon_or_end(const std::string& str, std::string::size_type pos)
+        {
+            auto first = pos;
+            while (true)
+            {
+                first = str.find_first_of(" \t;", first);
+                // an empty match at the end
+                if (std::string::npos == first) return{ str.size(), 0 };
+                const auto semicolon = str.find_first_not_of(" \t", first);
+                // whitespace at the end
+                if (std::string::npos == semicolon) return{ first, str.size() - first };
+                if (';' == str[semicolon])
+                {
+                    const auto last = str.find_first_not_of(" \t", semicolon + 1);
+                    return{ first, (std::string::npos != last ? last : str.size()) - first };
+                }
+                // whitespace on its own isn't a delimiter
+                first = semicolon;
+            }
+        }
+
+        // find the first delimiter in str, beginning at pos, and return the substring from pos to the delimiter (or end)
+        // set pos to the end of the delimiter
+        inline std::string substr_find(const std::string& str, std::string::size_type& pos, delimiter_matcher delimiter)
+        {
+            const auto match = delimiter(str, pos);
+            std::string substr = std::string::npos != match.first ? str.substr(pos, match.first - pos) : str.substr(pos);
+            pos = std::string::npos != match.first ? match.first + match.second : std::string::npos;
+            return substr;
+        }
+
         // <byte-string>
         const converter string_converter{ js2s, s2js };
 
@@ -139,7 +200,9 @@ namespace sdp
             };
         }
 
-        converter array_converter(const converter& converter, const std::string& delimiter)
+        // a delimited list of values, where the parse delimiter may be a fixed string, a regex or a delimiter matcher
+        template <typename ParseDelimiter>
+        inline converter make_array_converter(const converter& converter, const std::string& format_delimiter, ParseDelimiter parse_delimiter)
         {
             return{
                 [=](const web::json::value& v) {
@@ -148,7 +211,7 @@ namespace sdp
                     {
                         if (!each.is_null())
                         {
-                            if (!s.empty()) s += delimiter;
+                            if (!s.empty()) s += format_delimiter;
                             s += converter.format(each);
                         }
                     }
@@ -159,7 +222,7 @@ namespace sdp
                     size_t pos = 0;
                     while (std::string::npos != pos && s.size() != pos)
                     {
-                        auto each = substr_find(s, pos, delimiter);
+                        auto each = substr_find(s, pos, parse_delimiter);
                         // leading or repeated delimiters are an error
                         if (each.empty()) throw sdp_parse_error("unexpected delimiter");
                         web::json::push_back(v, converter.parse(each));
@@ -169,37 +232,16 @@ namespace sdp
             };
         }
 
+        converter array_converter(const converter& converter, const std::string& delimiter)
+        {
+            return make_array_converter(converter, delimiter, delimiter);
+        }
+
         // identical to above except that parse_delimiter is a regex pattern
-        // hmm, yes, should therefore refactor
+        // the regex is constructed once, rather than for every value parsed
         converter array_converter(const converter& converter, const std::string& format_delimiter, const std::string& parse_delimiter)
         {
-            return{
-                [=](const web::json::value& v) {
-                    std::string s;
-                    for (const auto& each : v.as_array())
-                    {
-                        if (!each.is_null())
-                        {
-                            if (!s.empty()) s += format_delimiter;
-                            s += converter.format(each);
-                        }
-                    }
-                    return s;
-                },
-                [=](const std::string& s) {
-                    const bst::regex delimiter{ parse_delimiter };
-                    auto v = web::json::value::array();
-                    size_t pos = 0;
-                    while (std::string::npos != pos && s.size() != pos)
-                    {
-                        auto each = substr_find(s, pos, delimiter);
-                        // leading or repeated delimiters are an error
-                        if (each.empty()) throw sdp_parse_error("unexpected delimiter");
-                        web::json::push_back(v, converter.parse(each));
-                    }
-                    return v;
-                }
-            };
+            return make_array_converter(converter, format_delimiter, bst::regex{ parse_delimiter });
         }
 
         const converter strings_converter = array_converter(string_converter, " ");
@@ -209,7 +251,7 @@ namespace sdp
         // media type parameter entries, separated by the semicolon (";") character followed by whitespace"
         // but RFC 4566 does not itself specify the syntax of format-specific parameters and many examples
         // in other RFCs and SMPTE standards are inconsistent, so allow additional whitespace
-        const converter named_values_converter = array_converter(key_value_converter('=', { sdp::fields::name, string_converter }, { sdp::fields::value, string_converter }), "; ", "[ \\t]*(;[ \\t]*|$)");
+        const converter named_values_converter = make_array_converter(key_value_converter('=', { sdp::fields::name, string_converter }, { sdp::fields::value, string_converter }), "; ", &match_semicolon_or_end); // i.e. "[ \\t]*(;[ \\t]*|$)"
 
         converter object_converter(const std::vector<std::pair<utility::string_t, converter>>& field_converters, const std::string& delimiter)
         {
@@ -621,8 +663,7 @@ namespace sdp
                         [](const std::string& s) {
                             auto v = web::json::value::object(keep_order);
                             size_t pos = 0;
-                            const bst::regex whitespace{ "[ \\t]+" };
-                            v[sdp::fields::format] = string_converter.parse(substr_find(s, pos, whitespace));
+                            v[sdp::fields::format] = string_converter.parse(substr_find(s, pos, &match_whitespace));
                             // handle no space after <format> if there are no <format specific parameters>
                             auto params = std::string::npos != pos ? substr_find(s, pos) : "";
                             v[sdp::fields::format_specific_parameters] = named_values_converter.parse(params);
@@ -856,7 +897,7 @@ namespace sdp
                         [](const std::string& s) {
                             auto v = web::json::value::object(keep_order);
                             size_t pos = 0;
-                            v[sdp::fields::local_id] = digits_converter.parse(substr_find(s, pos, bst::regex{ R"(\D)" }));
+                            v[sdp::fields::local_id] = digits_converter.parse(substr_find(s, pos, &match_non_digit));
                             if (s.at(pos - 1) == '/') v[sdp::fields::direction] = string_converter.parse(substr_find(s, pos, " "));
                             v[sdp::fields::uri] = string_converter.parse(substr_find(s, pos, " "));
                             if (std::string::npos != pos) v[sdp::fields::extensionattributes] = string_converter.parse(substr_find(s, pos));
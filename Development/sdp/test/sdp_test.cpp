@@ -1,6 +1,8 @@
 // The first "test" is of course whether the header compiles standalone
 #include "sdp/sdp.h"
 
+#include <random>
+#include "bst/regex.h"
 #include "bst/test/test.h"
 #include "sdp/json.h"
 #include "sdp/sdp_grammar.h"
@@ -1211,3 +1213,156 @@ a=recvonly
         BST_CHECK_EQUAL(expected_line, actual_line);
     } while (!expected.fail() && !actual.fail());
 }
+
+namespace
+{
+    // the previous, regex-based implementation of the delimiters of the fmtp and extmap attributes, for comparison
+
+    std::string regex_substr_find(const std::string& str, std::string::size_type& pos, const bst::regex& delimiter)
+    {
+        bst::smatch match;
+        const std::string::size_type end = bst::regex_search(str.begin() + pos, str.end(), match, delimiter) ? match[0].first - str.begin() : std::string::npos;
+        std::string substr = std::string::npos != end ? str.substr(pos, end - pos) : str.substr(pos);
+        pos = std::string::npos != end ? end + (match[0].second - match[0].first) : std::string::npos;
+        return substr;
+    }
+
+    std::string substr_find(const std::string& str, std::string::size_type& pos, const std::string& delimiter = {})
+    {
+        const std::string::size_type end = !delimiter.empty() ? str.find(delimiter, pos) : std::string::npos;
+        std::string substr = std::string::npos != end ? str.substr(pos, end - pos) : str.substr(pos);
+        pos = std::string::npos != end ? end + delimiter.size() : std::string::npos;
+        return substr;
+    }
+
+    const sdp::grammar::converter& regex_named_values_converter()
+    {
+        using namespace sdp::grammar;
+        static const converter named_values = array_converter(key_value_converter('=', { sdp::fields::name, string_converter }, { sdp::fields::value, string_converter }), "; ", "[ \\t]*(;[ \\t]*|$)");
+        return named_values;
+    }
+
+    web::json::value regex_parse_fmtp(const std::string& s)
+    {
+        using namespace sdp::grammar;
+        auto v = web::json::value::object(true);
+        size_t pos = 0;
+        v[sdp::fields::format] = string_converter.parse(regex_substr_find(s, pos, bst::regex{ "[ \\t]+" }));
+        auto params = std::string::npos != pos ? substr_find(s, pos) : "";
+        v[sdp::fields::format_specific_parameters] = regex_named_values_converter().parse(params);
+        return v;
+    }
+
+    web::json::value regex_parse_extmap(const std::string& s)
+    {
+        using namespace sdp::grammar;
+        auto v = web::json::value::object(true);
+        size_t pos = 0;
+        v[sdp::fields::local_id] = digits_converter.parse(regex_substr_find(s, pos, bst::regex{ R"(\D)" }));
+        if (s.at(pos - 1) == '/') v[sdp::fields::direction] = string_converter.parse(substr_find(s, pos, " "));
+        v[sdp::fields::uri] = string_converter.parse(substr_find(s, pos, " "));
+        if (std::string::npos != pos) v[sdp::fields::extensionattributes] = string_converter.parse(substr_find(s, pos));
+        return v;
+    }
+
+    web::json::value istream_parse_digits(const std::string& s)
+    {
+        uint64_t v;
+        std::istringstream is(s);
+        is >> v;
+        if (is.fail() || !is.eof()) throw std::runtime_error("expected a sequence of digits");
+        return web::json::value(v);
+    }
+
+    // parse, or return null if parsing throws
+    web::json::value parse_or_null(const sdp::grammar::converter::parser& parse, const std::string& s)
+    {
+        try
+        {
+            return parse(s);
+        }
+        catch (const std::exception&)
+        {
+            return web::json::value::null();
+        }
+    }
+
+    std::string random_string(std::mt19937& engine, const std::string& alphabet, size_t max_size)
+    {
+        std::string s(std::uniform_int_distribution<size_t>(0, max_size)(engine), ' ');
+        std::uniform_int_distribution<size_t> character(0, alphabet.size() - 1);
+        for (auto& c : s) c = alphabet[character(engine)];
+        return s;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Compare the delimiter matching of the default grammar with the previous regex-based implementation on random input
+BST_TEST_CASE(testSdpDelimiterEquivalence)
+{
+    const auto converters = sdp::grammar::get_default_attribute_converters();
+    const auto& fmtp = converters.at(sdp::attributes::fmtp).parse;
+    const auto& extmap = converters.at(sdp::attributes::extmap).parse;
+
+    std::mt19937 engine(42);
+    for (int i = 0; i < 20000; ++i)
+    {
+        const auto params = random_string(engine, " \t;=ab1", 16);
+        BST_CHECK_EQUAL(parse_or_null(regex_named_values_converter().parse, params), parse_or_null(sdp::grammar::named_values_converter.parse, params));
+
+        const auto fmtp_value = random_string(engine, " \t;=ab1", 16);
+        BST_CHECK_EQUAL(parse_or_null(regex_parse_fmtp, fmtp_value), parse_or_null(fmtp, fmtp_value));
+
+        const auto extmap_value = random_string(engine, " /a1", 12);
+        BST_CHECK_EQUAL(parse_or_null(regex_parse_extmap, extmap_value), parse_or_null(extmap, extmap_value));
+
+        const auto digits = random_string(engine, "0123456789 +x", 24);
+        BST_CHECK_EQUAL(parse_or_null(istream_parse_digits, digits), parse_or_null(sdp::grammar::digits_converter.parse, digits));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Check that the fmtp and extmap attributes, whose delimiters are matched by hand-written functions, roundtrip
+// in their canonical form, including with tabs and repeated whitespace, a trailing ';', and non-digit separators
+BST_TEST_CASE(testSdpDelimiterRoundtrip)
+{
+    const auto converters = sdp::grammar::get_default_attribute_converters();
+
+    const std::vector<std::pair<std::string, std::string>> fmtp_values = {
+        { "96", "96 " },
+        { "96\t", "96 " },
+        { "96 foo=meow; bar=purr", "96 foo=meow; bar=purr" },
+        { "96\t\tfoo=meow;\tbar=purr", "96 foo=meow; bar=purr" },
+        { "96 \t foo=meow  ;  bar=purr", "96 foo=meow; bar=purr" },
+        { "96 foo=meow;", "96 foo=meow" },
+        { "96 foo=meow; bar=purr;", "96 foo=meow; bar=purr" },
+        { "96 foo=meow ; \t", "96 foo=meow" }
+    };
+
+    const std::vector<std::pair<std::string, std::string>> extmap_values = {
+        { "1/sendonly urn:ietf:params:rtp-hdrext:toffset", "1/sendonly urn:ietf:params:rtp-hdrext:toffset" },
+        { "2 urn:example ext-attr", "2 urn:example ext-attr" },
+        { "3 urn:example  a  b", "3 urn:example  a  b" },
+        { "4\turn:example", "4 urn:example" },
+        { "42-urn:example", "42 urn:example" }
+    };
+
+    for (const auto& values : { std::make_pair(sdp::attributes::fmtp, fmtp_values), std::make_pair(sdp::attributes::extmap, extmap_values) })
+    {
+        const auto& converter = converters.at(values.first);
+        for (const auto& value : values.second)
+        {
+            const auto parsed = converter.parse(value.first);
+            BST_CHECK_EQUAL(value.second, converter.format(parsed));
+            BST_CHECK_EQUAL(parsed, converter.parse(value.second));
+        }
+    }
+
+    const auto& fmtp = converters.at(sdp::attributes::fmtp);
+    BST_REQUIRE_THROW(fmtp.parse("96\t;\t"), std::runtime_error);
+    BST_REQUIRE_THROW(fmtp.parse("96 foo=meow;\t;"), std::runtime_error);
+
+    const auto& extmap = converters.at(sdp::attributes::extmap);
+    BST_REQUIRE_THROW(extmap.parse("1"), std::exception);
+    BST_REQUIRE_THROW(extmap.parse("x urn:example"), std::runtime_error);
+}